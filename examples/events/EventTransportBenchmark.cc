@@ -0,0 +1,415 @@
+/*
+ * examples/events/EventTransportBenchmark.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+// Compares the transports available to subscribers of the AtomSpace
+// Publisher that run on the same host: ZeroMQ over tcp:// and ipc://,
+// and the shared memory ring. No CogServer is needed; messages of the
+// given size are pushed through each transport exactly the way the
+// publisher's proxy thread does it.
+//
+// In compression mode, it instead compresses synthetic tvChanged
+// messages in batches, with each available codec and level, with and
+// without a trained dictionary, and reports the compression ratio and
+// the CPU cost, as ZMQ_EVENT_COMPRESSION would incur them.
+//
+// Usage: event-transport-benchmark [messages] [message size]
+//        event-transport-benchmark compression [messages] [batch size]
+
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <lib/zmq/zhelpers.hpp>
+#include <opencog/util/exceptions.h>
+#include <opencog/events/EventCompressor.h>
+#include <opencog/events/EventRing.h>
+
+using namespace opencog;
+
+static const int LATENCY_SAMPLES = 10000;
+static const int LATENCY_GAP_NS = 20000;
+
+static uint64_t now_ns()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// The send time travels in the first eight bytes of the payload.
+static void stamp(std::string& payload)
+{
+	uint64_t t = now_ns();
+	memcpy(&payload[0], &t, sizeof(t));
+}
+
+static uint64_t age(const std::string& payload)
+{
+	uint64_t t;
+	memcpy(&t, payload.data(), sizeof(t));
+	return now_ns() - t;
+}
+
+static void pace(uint64_t since)
+{
+	while (now_ns() - since < LATENCY_GAP_NS) {}
+}
+
+struct result_t
+{
+	std::string transport;
+	double msgs_per_sec = 0;
+	double mb_per_sec = 0;
+	uint64_t received = 0;
+	std::vector<uint64_t> latency;
+};
+
+// One transport: how to send, and how to receive with a timeout.
+struct transport_t
+{
+	virtual ~transport_t() {}
+	virtual void send(const std::string& topic, const std::string& payload) = 0;
+	virtual bool recv(std::string& topic, std::string& payload) = 0;
+};
+
+struct zmq_transport_t : public transport_t
+{
+	zmq::context_t context;
+	zmq::socket_t publisher;
+	zmq::socket_t subscriber;
+
+	zmq_transport_t(const std::string& endpoint)
+		: context(1), publisher(context, ZMQ_PUB),
+		  subscriber(context, ZMQ_SUB)
+	{
+		int hwm = 10000000;
+		int timeout = 2000;
+		publisher.setsockopt(ZMQ_SNDHWM, &hwm, sizeof(hwm));
+		subscriber.setsockopt(ZMQ_RCVHWM, &hwm, sizeof(hwm));
+		subscriber.setsockopt(ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+		subscriber.setsockopt(ZMQ_SUBSCRIBE, "", 0);
+		publisher.bind(endpoint.c_str());
+		subscriber.connect(endpoint.c_str());
+
+		// Avoid the slow joiner syndrome
+		s_sleep(500);
+	}
+
+	void send(const std::string& topic, const std::string& payload)
+	{
+		s_sendmore(publisher, topic);
+		s_send(publisher, payload);
+	}
+
+	bool recv(std::string& topic, std::string& payload)
+	{
+		zmq::message_t message;
+		if (not subscriber.recv(&message)) return false;
+		topic.assign(static_cast<char*>(message.data()), message.size());
+		if (not subscriber.recv(&message)) return false;
+		payload.assign(static_cast<char*>(message.data()), message.size());
+		return true;
+	}
+};
+
+struct shm_transport_t : public transport_t
+{
+	EventRing ring;
+	EventRingSubscriber subscriber;
+
+	shm_transport_t(const std::string& name)
+		: ring(name, 64 * 1024 * 1024), subscriber(name) {}
+
+	void send(const std::string& topic, const std::string& payload)
+	{
+		ring.publish(topic, payload);
+	}
+
+	bool recv(std::string& topic, std::string& payload)
+	{
+		return subscriber.receive(topic, payload, 2000);
+	}
+};
+
+static result_t run(const std::string& name, transport_t& transport,
+                    int messages, size_t size)
+{
+	result_t result;
+	result.transport = name;
+	std::string payload(std::max(size, sizeof(uint64_t)), 'x');
+
+	// Throughput: the writer sends as fast as it can.
+	uint64_t start = now_ns();
+	std::thread writer([&] {
+		for (int i = 0; i < messages; i++)
+			transport.send("add", payload);
+	});
+	// Messages lost on the way (the ring never blocks its writer) end
+	// the loop by timeout, so the clock stops at the last arrival.
+	std::string topic, received;
+	uint64_t last = start;
+	while ((int) result.received < messages
+	       and transport.recv(topic, received))
+	{
+		result.received++;
+		last = now_ns();
+	}
+	double secs = (last - start) / 1e9;
+	writer.join();
+
+	result.msgs_per_sec = result.received / secs;
+	result.mb_per_sec = result.received * payload.size() / secs / 1e6;
+
+	// Latency: one message at a time, spaced out so that no queue
+	// builds up.
+	std::thread pinger([&] {
+		std::string p(payload);
+		for (int i = 0; i < LATENCY_SAMPLES; i++)
+		{
+			uint64_t sent = now_ns();
+			stamp(p);
+			transport.send("tvChanged", p);
+			pace(sent);
+		}
+	});
+	for (int i = 0; i < LATENCY_SAMPLES; i++)
+	{
+		if (not transport.recv(topic, received)) break;
+		result.latency.push_back(age(received));
+	}
+	pinger.join();
+
+	std::sort(result.latency.begin(), result.latency.end());
+	return result;
+}
+
+static double percentile(const std::vector<uint64_t>& v, double p)
+{
+	if (v.empty()) return 0;
+	size_t k = std::min(v.size() - 1, (size_t) (p / 100.0 * (v.size() - 1)));
+	return v[k] / 1000.0;
+}
+
+// A tvChanged message, shaped like the publisher's
+static std::string tv_message(std::mt19937_64& rng, uint64_t sequence)
+{
+	std::uniform_int_distribution<uint64_t> handle(1, 1000000);
+	std::uniform_real_distribution<double> value(0, 1);
+	uint64_t h = handle(rng);
+	uint64_t ns = 1700000000000000000ULL + sequence * 1000;
+	uint64_t secs = ns / 1000000000;
+	double s0 = value(rng), s1 = value(rng), c = value(rng);
+	char buf[1024];
+	snprintf(buf, sizeof(buf),
+		"{\"atom\":{\"attentionvalue\":{\"lti\":0,\"sti\":%d,\"vlti\":false},"
+		"\"handle\":\"%" PRIu64 "\",\"incoming\":[\"%" PRIu64 "\"],"
+		"\"name\":\"concept-%" PRIu64 "\",\"outgoing\":[],"
+		"\"truthvalue\":{\"details\":{\"confidence\":%.6f,\"count\":%.6f,"
+		"\"strength\":%.6f},\"type\":\"simple\"},\"type\":\"ConceptNode\"},"
+		"\"handle\":\"%" PRIu64 "\",\"monotonic_ns\":%" PRIu64 ","
+		"\"sequence\":%" PRIu64 ",\"timestamp\":%" PRIu64 ","
+		"\"timestamp_ns\":%" PRIu64 ","
+		"\"tvNew\":{\"details\":{\"confidence\":%.6f,\"count\":%.6f,"
+		"\"strength\":%.6f},\"type\":\"simple\"},"
+		"\"tvOld\":{\"details\":{\"confidence\":%.6f,\"count\":%.6f,"
+		"\"strength\":%.6f},\"type\":\"simple\"}}\n",
+		(int) (value(rng) * 100), h, handle(rng), h, c, c * 100, s1,
+		h, ns / 7, sequence, secs, ns,
+		c, c * 100, s1, c, c * 100, s0);
+	return buf;
+}
+
+struct codec_result_t
+{
+	std::string codec;
+	int level = 0;
+	bool dictionary = false;
+	double ratio = 0;
+	double compress_ns = 0;     // CPU per message
+	double decompress_ns = 0;   // wall clock per message
+};
+
+static codec_result_t run_codec(EventCompressor::Codec codec, int level,
+                                bool dictionary,
+                                const std::vector<std::string>& messages,
+                                size_t batch)
+{
+	codec_result_t result;
+	result.codec = EventCompressor::codecName(codec);
+
+	EventCompressor compressor(codec, level);
+	EventCompressor decompressor(codec, level);
+	result.level = compressor.level();
+	if (dictionary)
+	{
+		// Trained the way the publisher does it, from the first messages
+		for (const std::string& m : messages)
+			if (compressor.addSample(m, 1000, 16384)) break;
+		if (not compressor.trained()) return result;
+		decompressor.addDictionary(compressor.dictionary());
+		result.dictionary = true;
+	}
+
+	std::vector<std::pair<std::string, size_t>> blobs;
+	for (size_t i = 0; i < messages.size(); i += batch)
+	{
+		std::string raw;
+		size_t n = std::min(batch, messages.size() - i);
+		for (size_t j = i; j < i + n; j++)
+			EventCompressor::appendRecord(raw, messages[j]);
+		blobs.emplace_back(compressor.compress(raw, n), raw.size());
+	}
+
+	uint64_t start = now_ns();
+	for (const auto& b : blobs)
+		decompressor.decompress(b.first, b.second, compressor.dictionaryId());
+	uint64_t elapsed = now_ns() - start;
+
+	const EventCompressor::stats_t& stats = compressor.stats();
+	result.ratio = (double) stats.raw_bytes / stats.compressed_bytes;
+	result.compress_ns = (double) stats.cpu_ns / stats.messages;
+	result.decompress_ns = (double) elapsed / stats.messages;
+	return result;
+}
+
+static int compression(int messages, size_t batch)
+{
+	std::mt19937_64 rng(42);
+	std::vector<std::string> msgs;
+	size_t bytes = 0;
+	for (int i = 0; i < messages; i++)
+	{
+		msgs.push_back(tv_message(rng, i + 1));
+		bytes += msgs.back().size();
+	}
+
+	// Unavailable codecs are skipped.
+	const std::pair<const char*, int> codecs[] = {
+		{"lz4", 0}, {"lz4", 9}, {"zstd", 1}, {"zstd", 3}, {"zstd", 9}
+	};
+	std::vector<codec_result_t> results;
+	for (const auto& c : codecs)
+	{
+		EventCompressor::Codec codec;
+		try
+		{
+			codec = EventCompressor::parseCodec(c.first);
+		}
+		catch (const InvalidParamException&)
+		{
+			continue;
+		}
+		for (bool dictionary : {false, true})
+		{
+			codec_result_t r = run_codec(codec, c.second, dictionary,
+			                             msgs, batch);
+			if (dictionary == r.dictionary)
+				results.push_back(r);
+		}
+	}
+	if (results.empty())
+	{
+		std::cerr << "Built without lz4 or zstd" << std::endl;
+		return 1;
+	}
+
+	std::cout << messages << " messages of " << bytes / messages
+	          << " bytes on average, in batches of " << batch << std::endl;
+	std::cout << std::left << std::setw(6) << "" << std::right
+	          << std::setw(7) << "level"
+	          << std::setw(6) << "dict"
+	          << std::setw(8) << "ratio"
+	          << std::setw(14) << "compress ns"
+	          << std::setw(10) << "MB/s"
+	          << std::setw(16) << "decompress ns"
+	          << std::setw(10) << "MB/s" << std::endl;
+	std::cout << std::fixed;
+	double avg = (double) bytes / messages;
+	for (const codec_result_t& r : results)
+	{
+		std::cout << std::left << std::setw(6) << r.codec << std::right
+		          << std::setw(7) << r.level
+		          << std::setw(6) << (r.dictionary ? "yes" : "no")
+		          << std::setw(8) << std::setprecision(2) << r.ratio
+		          << std::setw(14) << std::setprecision(0) << r.compress_ns
+		          << std::setw(10) << avg / r.compress_ns * 1e3
+		          << std::setw(16) << r.decompress_ns
+		          << std::setw(10) << avg / r.decompress_ns * 1e3
+		          << std::endl;
+	}
+	return 0;
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 and std::string(argv[1]) == "compression")
+		return compression(argc > 2 ? atoi(argv[2]) : 100000,
+		                   argc > 3 ? atoi(argv[3]) : 64);
+
+	int messages = argc > 1 ? atoi(argv[1]) : 1000000;
+	size_t size = argc > 2 ? atoi(argv[2]) : 512;
+	std::string suffix = std::to_string(getpid());
+
+	std::vector<result_t> results;
+	{
+		zmq_transport_t tcp("tcp://127.0.0.1:15563");
+		results.push_back(run("tcp", tcp, messages, size));
+	}
+	{
+		zmq_transport_t ipc("ipc:///tmp/event-benchmark-" + suffix);
+		results.push_back(run("ipc", ipc, messages, size));
+	}
+	{
+		shm_transport_t shm("/event-benchmark-" + suffix);
+		results.push_back(run("shm", shm, messages, size));
+	}
+
+	std::cout << messages << " messages of " << size << " bytes" << std::endl;
+	std::cout << std::left << std::setw(6) << "" << std::right
+	          << std::setw(12) << "received"
+	          << std::setw(12) << "msgs/s"
+	          << std::setw(10) << "MB/s"
+	          << std::setw(10) << "p50 us"
+	          << std::setw(10) << "p99 us"
+	          << std::setw(10) << "p99.9 us"
+	          << std::setw(10) << "max us" << std::endl;
+	std::cout << std::fixed << std::setprecision(1);
+	for (const result_t& r : results)
+	{
+		std::cout << std::left << std::setw(6) << r.transport << std::right
+		          << std::setw(12) << r.received
+		          << std::setw(12) << std::setprecision(0) << r.msgs_per_sec
+		          << std::setw(10) << std::setprecision(1) << r.mb_per_sec
+		          << std::setw(10) << percentile(r.latency, 50)
+		          << std::setw(10) << percentile(r.latency, 99)
+		          << std::setw(10) << percentile(r.latency, 99.9)
+		          << std::setw(10) << percentile(r.latency, 100)
+		          << std::endl;
+	}
+	return 0;
+}
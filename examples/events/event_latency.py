@@ -0,0 +1,210 @@
+#! /usr/bin/env python3
+"""
+Latency distributions for the AtomSpace Publisher
+
+Subscribes to the event publisher and reports how old each event is when
+it arrives, using the timestamps the publisher takes in its signal
+handlers. With ZMQ_EVENT_TRACE = TRUE in opencog.conf, the time spent in
+each stage of the publishing pipeline is reported as well:
+
+  signal -> started       waiting for a TBB worker
+  started -> serialized   serializing the event
+  serialized -> sent      waiting in the publisher queue (and batching)
+  sent -> received        ZeroMQ transport
+
+The stage timestamps, and the 'monotonic' end-to-end figure, use the
+steady clock and are only meaningful when this script runs on the same
+host as the CogServer. The 'wall' end-to-end figure works across hosts,
+provided their clocks are synchronized.
+
+Each report covers the events received since the previous one, so
+memory use stays bounded however long the script runs.
+
+Compressed batches (ZMQ_EVENT_COMPRESSION) are understood if the
+'zstandard' or 'lz4' Python modules are installed.
+
+Dependencies:
+pip install pyzmq
+
+Usage:
+python3 event_latency.py --endpoint tcp://127.0.0.1:5563 --count 100000
+"""
+
+import argparse
+import json
+import struct
+import sys
+import time
+
+import zmq
+
+TOPICS = ['add', 'remove', 'tvChanged', 'avChanged', 'addAF', 'removeAF']
+STAGES = [('signal', 'started'), ('started', 'serialized'),
+          ('serialized', 'sent'), ('sent', 'received')]
+PERCENTILES = [50, 90, 99, 99.9]
+
+
+class Decompressor(object):
+    """
+    Decodes the compressed batches described in opencog/events/README.md
+    """
+
+    def __init__(self):
+        self.dictionaries = {}
+
+    def add_dictionary(self, header, data):
+        self.dictionaries[header['dictionary']] = data
+
+    def split(self, header, blob):
+        raw = self.decompress(header, blob)
+        records = []
+        pos = 0
+        while pos + 4 <= len(raw):
+            (length,) = struct.unpack_from('<I', raw, pos)
+            pos += 4
+            records.append(raw[pos:pos + length])
+            pos += length
+        return records
+
+    def decompress(self, header, blob):
+        dict_data = self.dictionaries.get(header['dictionary'])
+        if header['dictionary'] != 0 and dict_data is None:
+            raise KeyError('dictionary %d not received yet' %
+                           header['dictionary'])
+        if header['codec'] == 'zstd':
+            import zstandard
+            if dict_data is not None:
+                dctx = zstandard.ZstdDecompressor(
+                    dict_data=zstandard.ZstdCompressionDict(dict_data))
+            else:
+                dctx = zstandard.ZstdDecompressor()
+            return dctx.decompress(blob, max_output_size=header['size'])
+        if header['codec'] == 'lz4':
+            import lz4.block
+            return lz4.block.decompress(blob,
+                                        uncompressed_size=header['size'],
+                                        dict=dict_data or b'')
+        return blob
+
+
+def percentile(ordered, p):
+    if not ordered:
+        return 0
+    k = min(len(ordered) - 1, int(round(p / 100.0 * (len(ordered) - 1))))
+    return ordered[k]
+
+
+def new_samples():
+    samples = {'end-to-end (wall)': [], 'end-to-end (monotonic)': []}
+    for start, end in STAGES:
+        samples[start + ' -> ' + end] = []
+    return samples
+
+
+def report(samples, elapsed, received, total):
+    print('\n%d events in %.1f s (%.0f events/s), %d in all' %
+          (received, elapsed, received / elapsed if elapsed > 0 else 0,
+           total))
+    print('%-24s %10s %10s %10s %10s %10s' %
+          (('latency (us)',) + tuple('p%g' % p for p in PERCENTILES) +
+           ('max',)))
+    for name, values in samples.items():
+        if not values:
+            continue
+        ordered = sorted(values)
+        print('%-24s %10.1f %10.1f %10.1f %10.1f %10.1f' %
+              ((name,) + tuple(percentile(ordered, p) / 1000.0
+                               for p in PERCENTILES) +
+               (ordered[-1] / 1000.0,)))
+    sys.stdout.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split('\n')[1])
+    parser.add_argument('--endpoint', default='tcp://127.0.0.1:5563')
+    parser.add_argument('--topic', action='append',
+                        help='event type to measure (default: all)')
+    parser.add_argument('--count', type=int, default=0,
+                        help='stop after this many events (default: never)')
+    parser.add_argument('--interval', type=float, default=10.0,
+                        help='seconds between reports')
+    args = parser.parse_args()
+
+    context = zmq.Context(1)
+    subscriber = context.socket(zmq.SUB)
+    subscriber.connect(args.endpoint)
+    topics = args.topic or TOPICS
+    for topic in topics:
+        subscriber.setsockopt_string(zmq.SUBSCRIBE, topic)
+        for codec in ['lz4', 'zstd']:
+            subscriber.setsockopt_string(zmq.SUBSCRIBE, codec + ':' + topic)
+    subscriber.setsockopt_string(zmq.SUBSCRIBE, 'dictionary')
+
+    decompressor = Decompressor()
+    samples = new_samples()
+
+    received = 0
+    total = 0
+    last_report = time.monotonic()
+
+    def record(payload, trace, now_wall, now_mono):
+        message = json.loads(payload)
+        trace = trace or message.get('trace')
+        if 'timestamp_ns' in message:
+            samples['end-to-end (wall)'].append(
+                now_wall - message['timestamp_ns'])
+            samples['end-to-end (monotonic)'].append(
+                now_mono - message['monotonic_ns'])
+        if trace:
+            trace = dict(trace, received=now_mono)
+            for start, end in STAGES:
+                if start in trace and end in trace:
+                    samples[start + ' -> ' + end].append(
+                        trace[end] - trace[start])
+
+    try:
+        while args.count == 0 or total < args.count:
+            frames = subscriber.recv_multipart()
+            now_wall = time.time_ns()
+            now_mono = time.monotonic_ns()
+            topic = frames[0].decode()
+
+            if topic == 'dictionary':
+                decompressor.add_dictionary(json.loads(frames[1]), frames[2])
+                continue
+
+            # Subscriptions match by prefix: "add" also gets "addAF".
+            if topic.split(':', 1)[-1] not in topics:
+                continue
+
+            if ':' in topic:
+                header = json.loads(frames[1])
+                try:
+                    records = decompressor.split(header, frames[2])
+                except (KeyError, ImportError) as e:
+                    print('Skipping %s batch: %s' % (topic, e))
+                    continue
+                traces = header.get('trace', [None] * len(records))
+                for payload, trace in zip(records, traces):
+                    record(payload, trace, now_wall, now_mono)
+                received += len(records)
+                total += len(records)
+            else:
+                record(frames[1], None, now_wall, now_mono)
+                received += 1
+                total += 1
+
+            if now_mono / 1e9 - last_report >= args.interval:
+                report(samples, now_mono / 1e9 - last_report, received,
+                       total)
+                last_report = now_mono / 1e9
+                samples = new_samples()
+                received = 0
+    except KeyboardInterrupt:
+        pass
+
+    report(samples, time.monotonic() - last_report, received, total)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,159 @@
+#! /usr/bin/env python3
+"""
+Synthetic AtomSpaces for load testing
+
+Writes a Scheme file of nodes and binary links whose degree distribution
+follows a power law, as in most real knowledge graphs: a few hub nodes
+take part in a large share of the links. The same parameters and seed
+always give the same file, so that runs before and after a change are
+made against the same data.
+
+A JSON manifest is written next to the Scheme file. It records the
+parameters and where each node type lives, so that loadgen.py can
+address atoms by type and name without asking the server.
+
+Node names are n0, n1, ... Nodes are split between the node types in
+the proportions given by --node-mix, in contiguous ranges. Each link
+joins two distinct nodes, chosen with probability proportional to
+rank^(-1/(gamma-1)) in a random ranking of the nodes, which gives a
+degree distribution with tail exponent gamma. Link types must accept
+any two atoms (InheritanceLink, SimilarityLink, ListLink, ...).
+
+Usage:
+python3 fixtures.py --nodes 100000 --links 300000 --gamma 2.1 \\
+    --node-mix ConceptNode:0.8,PredicateNode:0.2 \\
+    --link-mix InheritanceLink:0.7,SimilarityLink:0.3 \\
+    --seed 42 --output fixture.scm
+"""
+
+import argparse
+import itertools
+import json
+import random
+import time
+
+DEFAULT_NODE_MIX = 'ConceptNode:0.8,PredicateNode:0.2'
+DEFAULT_LINK_MIX = 'InheritanceLink:0.6,SimilarityLink:0.2,ListLink:0.2'
+
+# Links are drawn this many at a time
+BATCH = 10000
+
+
+def parse_mix(text):
+    """'ConceptNode:0.8,PredicateNode:0.2' -> [(type, weight), ...]"""
+    mix = []
+    for item in text.split(','):
+        name, _, weight = item.strip().partition(':')
+        mix.append((name, float(weight or 1)))
+    total = sum(w for _, w in mix)
+    if total <= 0:
+        raise ValueError('empty type mix: ' + text)
+    return [(name, w / total) for name, w in mix]
+
+
+def node_ranges(nodes, mix):
+    """Contiguous [first, first + count) ranges of node ids per type."""
+    ranges = []
+    first = 0
+    for i, (name, weight) in enumerate(mix):
+        count = nodes - first if i == len(mix) - 1 \
+            else int(round(nodes * weight))
+        ranges.append({'type': name, 'first': first, 'count': count})
+        first += count
+    return ranges
+
+
+def node_type(ranges, node):
+    for r in ranges:
+        if node < r['first'] + r['count']:
+            return r['type']
+    raise IndexError(node)
+
+
+def stv(rng):
+    return '(stv %.3f %.3f)' % (rng.random(), rng.uniform(0.1, 0.9))
+
+
+def generate(args):
+    rng = random.Random(args.seed)
+    node_mix = parse_mix(args.node_mix)
+    link_mix = parse_mix(args.link_mix)
+    ranges = node_ranges(args.nodes, node_mix)
+
+    # Hubs are spread across the node types by ranking the nodes in a
+    # random order.
+    ranking = list(range(args.nodes))
+    rng.shuffle(ranking)
+    exponent = 1.0 / (args.gamma - 1.0)
+    cum_weights = list(itertools.accumulate(
+        (rank + 1) ** -exponent for rank in range(args.nodes)))
+    link_types = [name for name, _ in link_mix]
+    link_weights = [w for _, w in link_mix]
+
+    with open(args.output, 'w') as out:
+        out.write(';; Synthetic AtomSpace: %d nodes, %d links, gamma %.2f, '
+                  'seed %d\n' % (args.nodes, args.links, args.gamma,
+                                 args.seed))
+        for r in ranges:
+            for node in range(r['first'], r['first'] + r['count']):
+                out.write('(%s "n%d" %s)\n' % (r['type'], node, stv(rng)))
+
+        written = 0
+        while written < args.links:
+            batch = min(BATCH, args.links - written)
+            ends = rng.choices(ranking, cum_weights=cum_weights, k=2 * batch)
+            types = rng.choices(link_types, link_weights, k=batch)
+            for i in range(batch):
+                a, b = ends[2 * i], ends[2 * i + 1]
+                while a == b:
+                    b = rng.choices(ranking, cum_weights=cum_weights)[0]
+                out.write('(%s %s (%s "n%d") (%s "n%d"))\n' % (
+                    types[i], stv(rng),
+                    node_type(ranges, a), a, node_type(ranges, b), b))
+            written += batch
+
+    manifest = {
+        'scm': args.output,
+        'seed': args.seed,
+        'nodes': args.nodes,
+        'links': args.links,
+        'gamma': args.gamma,
+        'node_ranges': ranges,
+        'link_mix': link_mix,
+        # Node ids from the most to the least linked, for clients that
+        # want to hit the hubs
+        'ranking': ranking[:1000],
+    }
+    with open(manifest_name(args.output), 'w') as out:
+        json.dump(manifest, out, indent=2)
+
+
+def manifest_name(scm):
+    return (scm[:-4] if scm.endswith('.scm') else scm) + '.json'
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Write a synthetic AtomSpace with a power-law degree '
+                    'distribution')
+    parser.add_argument('--nodes', type=int, default=10000)
+    parser.add_argument('--links', type=int, default=30000)
+    parser.add_argument('--gamma', type=float, default=2.1,
+                        help='degree distribution exponent, > 1 (2.1)')
+    parser.add_argument('--node-mix', default=DEFAULT_NODE_MIX)
+    parser.add_argument('--link-mix', default=DEFAULT_LINK_MIX)
+    parser.add_argument('--seed', type=int, default=42)
+    parser.add_argument('--output', default='fixture.scm')
+    args = parser.parse_args()
+    if args.gamma <= 1 or args.nodes < 2:
+        parser.error('need gamma > 1 and at least two nodes')
+
+    start = time.time()
+    generate(args)
+    print('Wrote %s and %s: %d nodes, %d links in %.1f s' % (
+        args.output, manifest_name(args.output), args.nodes, args.links,
+        time.time() - start))
+
+
+if __name__ == '__main__':
+    main()
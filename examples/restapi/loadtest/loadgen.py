@@ -0,0 +1,410 @@
+#! /usr/bin/env python3
+"""
+Load generator for the REST API and the AtomSpace Publisher
+
+Drives the REST API with concurrent clients, against an AtomSpace built
+by fixtures.py, and reports the throughput and latency percentiles of
+each kind of request, the memory of the server, and, if asked, the rate
+and delivery latency of the events published meanwhile. Results can be
+saved, and compared with a saved baseline.
+
+Each client runs in its own thread, over its own keep-alive connection,
+choosing requests at random in the proportions given by --mix:
+
+  name    GET /atoms?type=T&name=N      look up one node
+  id      GET /atoms/H                  fetch a node by handle
+  type    GET /atoms?type=T&limit=100   list atoms by type
+  post    POST /atoms                   create a new node
+  types   GET /types                    half of them with If-None-Match
+  scheme  POST /scheme                  (cog-node 'T "N")
+
+Half of the node lookups go to the 1000 most linked nodes, the others to
+any node. Runs with the same --seed make the same choices: each client
+has its own random generator, and only fetches by id the handles that
+its own lookups returned.
+
+The load generator's own CPU use is reported: when it approaches one
+core, the clients, not the server, are the bottleneck.
+
+Dependencies:
+pip install pyzmq   (only for --events)
+
+Usage:
+python3 fixtures.py --nodes 100000 --links 300000 --output fixture.scm
+python3 server.py fixture.scm &
+python3 loadgen.py --manifest fixture.json --clients 16 --duration 60 \\
+    --pid $! --events tcp://127.0.0.1:5563 --save run.json \\
+    --baseline baseline.json
+"""
+
+import argparse
+import http.client
+import json
+import os
+import random
+import threading
+import time
+import urllib.parse
+
+DEFAULT_MIX = 'name:40,id:20,type:5,post:15,types:10,scheme:10'
+PERCENTILES = [50, 90, 99, 99.9]
+HUBS = 1000
+MAX_HANDLES = 10000       # remembered per client, for id lookups
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    k = min(len(values) - 1, int(p / 100.0 * (len(values) - 1)))
+    return values[k]
+
+
+def summarize(latencies, errors, seconds):
+    latencies = sorted(latencies)
+    summary = {
+        'requests': len(latencies),
+        'errors': errors,
+        'per_second': len(latencies) / seconds,
+        'max_ms': latencies[-1] * 1e3 if latencies else 0.0,
+    }
+    for p in PERCENTILES:
+        summary['p%s_ms' % p] = percentile(latencies, p) * 1e3
+    return summary
+
+
+class Workload(object):
+    """What the clients know about the AtomSpace under test."""
+
+    def __init__(self, manifest):
+        self.ranges = manifest['node_ranges']
+        self.nodes = manifest['nodes']
+        self.hubs = manifest['ranking'][:HUBS]
+
+    def node(self, rng):
+        if rng.random() < 0.5:
+            node = rng.choice(self.hubs)
+        else:
+            node = rng.randrange(self.nodes)
+        for r in self.ranges:
+            if node < r['first'] + r['count']:
+                return r['type'], 'n%d' % node
+
+    def node_type(self, rng):
+        return rng.choices([r['type'] for r in self.ranges],
+                           [r['count'] for r in self.ranges])[0]
+
+
+class Client(threading.Thread):
+    def __init__(self, number, args, workload, start, measure_from, stop_at):
+        super(Client, self).__init__(daemon=True)
+        self.number = number
+        self.url = urllib.parse.urlparse(args.url)
+        self.prefix = self.url.path.rstrip('/') + '/'
+        self.workload = workload
+        self.mix = args.mix
+        self.rng = random.Random(args.seed * 1000 + number)
+        self.start_at = start
+        self.measure_from = measure_from
+        self.stop_at = stop_at
+        self.connection = None
+        self.etag = None
+        self.created = 0
+        self.handles = []
+        self.latencies = dict((op, []) for op, _ in self.mix)
+        self.errors = dict((op, 0) for op, _ in self.mix)
+
+    def request(self, method, path, body=None, headers={}):
+        if self.connection is None:
+            self.connection = http.client.HTTPConnection(
+                self.url.hostname, self.url.port or 80, timeout=60)
+        if body is not None:
+            body = json.dumps(body)
+            headers = dict(headers, **{'Content-Type': 'application/json'})
+        try:
+            self.connection.request(method, self.prefix + path, body, headers)
+            response = self.connection.getresponse()
+            return response.status, response.read(), response
+        except (http.client.HTTPException, OSError):
+            self.connection.close()
+            self.connection = None
+            return 0, b'', None
+
+    def op_name(self):
+        type, name = self.workload.node(self.rng)
+        status, data, _ = self.request(
+            'GET', 'atoms?' + urllib.parse.urlencode(
+                {'type': type, 'name': name}))
+        if status == 200 and len(self.handles) < MAX_HANDLES:
+            for atom in json.loads(data)['result']['atoms']:
+                self.handles.append(atom['handle'])
+        return status == 200
+
+    def op_id(self):
+        if not self.handles:
+            return self.op_name()
+        handle = self.rng.choice(self.handles)
+        return self.request('GET', 'atoms/%d' % handle)[0] == 200
+
+    def op_type(self):
+        type = self.workload.node_type(self.rng)
+        return self.request('GET', 'atoms?' + urllib.parse.urlencode(
+            {'type': type, 'limit': 100}))[0] == 200
+
+    def op_post(self):
+        self.created += 1
+        atom = {'type': 'ConceptNode',
+                'name': 'load-%d-%d' % (self.number, self.created),
+                'truthvalue': {'type': 'simple',
+                               'details': {'strength': 0.5, 'count': 0.1}}}
+        return self.request('POST', 'atoms', atom)[0] == 200
+
+    def op_types(self):
+        headers = {}
+        if self.etag is not None and self.rng.random() < 0.5:
+            headers['If-None-Match'] = self.etag
+        status, _, response = self.request('GET', 'types', headers=headers)
+        if status == 200:
+            self.etag = response.getheader('ETag')
+        return status in (200, 304)
+
+    def op_scheme(self):
+        type, name = self.workload.node(self.rng)
+        command = '(cog-node \'%s "%s")' % (type, name)
+        return self.request('POST', 'scheme', {'command': command})[0] == 200
+
+    def run(self):
+        operations = [op for op, _ in self.mix]
+        weights = [w for _, w in self.mix]
+        while time.time() < self.start_at:
+            time.sleep(0.001)
+        while True:
+            op = self.rng.choices(operations, weights)[0]
+            start = time.time()
+            if start >= self.stop_at:
+                break
+            ok = getattr(self, 'op_' + op)()
+            if start >= self.measure_from:
+                if ok:
+                    self.latencies[op].append(time.time() - start)
+                else:
+                    self.errors[op] += 1
+
+
+class MemorySampler(threading.Thread):
+    """Resident set size of the server, from /proc."""
+
+    def __init__(self, pid, stop):
+        super(MemorySampler, self).__init__(daemon=True)
+        self.pid = pid
+        self.stop = stop
+        self.samples = []
+
+    def rss(self):
+        with open('/proc/%d/status' % self.pid) as status:
+            for line in status:
+                if line.startswith('VmRSS:'):
+                    return int(line.split()[1]) * 1024
+        return 0
+
+    def run(self):
+        while not self.stop.is_set():
+            try:
+                self.samples.append(self.rss())
+            except (IOError, ValueError):
+                break
+            self.stop.wait(0.5)
+
+    def summary(self):
+        if not self.samples:
+            return None
+        mb = 1024.0 * 1024.0
+        return {'start_mb': self.samples[0] / mb,
+                'peak_mb': max(self.samples) / mb,
+                'end_mb': self.samples[-1] / mb}
+
+
+class EventCounter(threading.Thread):
+    """Counts the publisher's events, and how long they took to arrive."""
+
+    def __init__(self, endpoint, measure_from, stop_at):
+        super(EventCounter, self).__init__(daemon=True)
+        import zmq
+        self.zmq = zmq
+        self.socket = zmq.Context.instance().socket(zmq.SUB)
+        self.socket.setsockopt(zmq.SUBSCRIBE, b'')
+        self.socket.setsockopt(zmq.RCVTIMEO, 200)
+        self.socket.connect(endpoint)
+        self.measure_from = measure_from
+        self.stop_at = stop_at
+        self.events = 0
+        self.ages = []
+
+    def run(self):
+        while time.time() < self.stop_at:
+            try:
+                frames = self.socket.recv_multipart()
+            except self.zmq.Again:
+                continue
+            if time.time() < self.measure_from or len(frames) < 2:
+                continue
+            topic = frames[0].decode('utf-8', 'replace')
+            if topic == 'dictionary':
+                continue
+            if ':' in topic:
+                # A compressed batch; see opencog/events/README.md
+                self.events += json.loads(frames[1])['count']
+                continue
+            self.events += 1
+            sent = json.loads(frames[1]).get('timestamp_ns')
+            if sent:
+                self.ages.append(time.time() - sent / 1e9)
+        self.socket.close()
+
+    def summary(self, seconds):
+        ages = sorted(self.ages)
+        summary = {'events': self.events,
+                   'per_second': self.events / seconds}
+        for p in PERCENTILES:
+            summary['p%s_ms' % p] = percentile(ages, p) * 1e3
+        return summary
+
+
+def parse_mix(text):
+    mix = []
+    for item in text.split(','):
+        op, _, weight = item.strip().partition(':')
+        if not hasattr(Client, 'op_' + op):
+            raise argparse.ArgumentTypeError('unknown request type ' + op)
+        mix.append((op, float(weight or 1)))
+    return mix
+
+
+def report(results, baseline):
+    columns = ['requests', 'errors', 'per_second'] + \
+        ['p%s_ms' % p for p in PERCENTILES] + ['max_ms']
+    print('%-8s' % '' + ''.join('%11s' % c.replace('_ms', ' ms')
+                                 .replace('per_second', 'req/s')
+                                 for c in columns))
+    rows = list(results['operations'].items()) + \
+        [('total', results['total'])]
+    for op, s in rows:
+        print('%-8s' % op + ''.join(
+            '%11d' % s[c] if c in ('requests', 'errors') else '%11.1f' % s[c]
+            for c in columns))
+
+    rss = results.get('server_rss')
+    if rss:
+        print('server RSS: start %.1f MB, peak %.1f MB, end %.1f MB' % (
+            rss['start_mb'], rss['peak_mb'], rss['end_mb']))
+    events = results.get('events')
+    if events:
+        print('events: %d (%.1f/s), delivery p50 %.2f ms, p99 %.2f ms, '
+              'p99.9 %.2f ms' % (events['events'], events['per_second'],
+                                 events['p50_ms'], events['p99_ms'],
+                                 events['p99.9_ms']))
+    print('load generator CPU: %.2f cores' % results['client_cores'])
+
+    if baseline is None:
+        return
+    print('\nchange from baseline:')
+    print('%-8s%11s%11s' % ('', 'req/s', 'p99 ms'))
+    old = dict(baseline['operations'], total=baseline['total'])
+    for op, s in rows:
+        if op not in old:
+            continue
+
+        def change(key):
+            before = old[op][key]
+            return (s[key] - before) / before * 100.0 if before else 0.0
+        print('%-8s%+10.1f%%%+10.1f%%' % (op, change('per_second'),
+                                         change('p99_ms')))
+    if rss and baseline.get('server_rss'):
+        print('server peak RSS: %+.1f MB' % (
+            rss['peak_mb'] - baseline['server_rss']['peak_mb']))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Load test the REST API and the event publisher')
+    parser.add_argument('--manifest', required=True,
+                        help='JSON manifest written by fixtures.py')
+    parser.add_argument('--url', default='http://127.0.0.1:5000/api/v1.1/')
+    parser.add_argument('--clients', type=int, default=8)
+    parser.add_argument('--duration', type=float, default=30,
+                        help='seconds measured, after the warmup')
+    parser.add_argument('--warmup', type=float, default=5)
+    parser.add_argument('--mix', type=parse_mix, default=DEFAULT_MIX)
+    parser.add_argument('--seed', type=int, default=1)
+    parser.add_argument('--pid', type=int,
+                        help='server process, to sample its memory')
+    parser.add_argument('--events',
+                        help='publisher endpoint, e.g. tcp://127.0.0.1:5563')
+    parser.add_argument('--save', help='write the results to this file')
+    parser.add_argument('--baseline',
+                        help='compare with results saved by an earlier run')
+    args = parser.parse_args()
+    if isinstance(args.mix, str):
+        args.mix = parse_mix(args.mix)
+
+    with open(args.manifest) as f:
+        workload = Workload(json.load(f))
+    baseline = None
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+
+    start = time.time() + 0.5
+    measure_from = start + args.warmup
+    stop_at = measure_from + args.duration
+
+    stop = threading.Event()
+    memory = MemorySampler(args.pid, stop) if args.pid else None
+    events = EventCounter(args.events, measure_from, stop_at) \
+        if args.events else None
+    clients = [Client(n, args, workload, start, measure_from, stop_at)
+               for n in range(args.clients)]
+
+    cpu = os.times()
+    for thread in [memory, events] + clients:
+        if thread is not None:
+            thread.start()
+    for client in clients:
+        client.join()
+    stop.set()
+    if events is not None:
+        events.join()
+    if memory is not None:
+        memory.join()
+    cpu_end = os.times()
+
+    results = {
+        'parameters': {'manifest': args.manifest, 'url': args.url,
+                       'clients': args.clients, 'duration': args.duration,
+                       'mix': dict(args.mix), 'seed': args.seed},
+        'operations': {},
+        'client_cores': ((cpu_end.user - cpu.user)
+                         + (cpu_end.system - cpu.system))
+        / (time.time() - start),
+    }
+    all_latencies, all_errors = [], 0
+    for op, _ in args.mix:
+        latencies = sum((c.latencies[op] for c in clients), [])
+        errors = sum(c.errors[op] for c in clients)
+        results['operations'][op] = summarize(latencies, errors,
+                                              args.duration)
+        all_latencies += latencies
+        all_errors += errors
+    results['total'] = summarize(all_latencies, all_errors, args.duration)
+    if memory is not None:
+        results['server_rss'] = memory.summary()
+    if events is not None:
+        results['events'] = events.summary(args.duration)
+
+    report(results, baseline)
+    if args.save:
+        with open(args.save, 'w') as f:
+            json.dump(results, f, indent=2)
+
+
+if __name__ == '__main__':
+    main()
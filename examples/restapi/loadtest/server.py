@@ -0,0 +1,45 @@
+#! /usr/bin/env python3
+"""
+Starts the REST API on an AtomSpace loaded with a synthetic fixture
+
+The server under test for loadgen.py, when the REST API is not hosted
+by a CogServer. It prints its process id, which loadgen.py takes (with
+--pid) to sample the server's memory.
+
+Usage:
+python3 server.py fixture.scm --port 5000
+"""
+
+import argparse
+import os
+import time
+
+from opencog.atomspace import AtomSpace
+from opencog.utilities import initialize_opencog
+from opencog.scheme_wrapper import scheme_eval
+from opencog.web.api.apimain import RESTAPI
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Serve the REST API on a synthetic AtomSpace')
+    parser.add_argument('fixture', help='Scheme file written by fixtures.py')
+    parser.add_argument('--host', default='127.0.0.1')
+    parser.add_argument('--port', type=int, default=5000)
+    args = parser.parse_args()
+
+    atomspace = AtomSpace()
+    initialize_opencog(atomspace)
+
+    start = time.time()
+    scheme_eval(atomspace, '(load "%s")' % os.path.abspath(args.fixture))
+    print('Loaded %d atoms in %.1f s' % (atomspace.size(),
+                                         time.time() - start))
+    print('Server pid %d, listening on http://%s:%d/api/v1.1/' % (
+        os.getpid(), args.host, args.port))
+
+    RESTAPI(atomspace).run(host=args.host, port=args.port)
+
+
+if __name__ == '__main__':
+    main()
@@ -22,10 +22,14 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
+#include <fstream>
+#include <chrono>
 #include <iomanip>
 #include <iostream>
+#include <sstream>
 #include <thread>
-#include <time.h>
+#include <unordered_set>
 
 #include <lib/zmq/zhelpers.hpp>
 #include <tbb/task.h>
@@ -46,6 +50,7 @@
 #include <opencog/cogserver/server/CogServer.h>
 #include <opencog/attentionbank/bank/AttentionBank.h>
 #include "AtomSpacePublisherModule.h"
+#include "AtomSpaceSnapshot.h"
 
 using namespace std;
 using namespace std::placeholders;
@@ -64,15 +69,41 @@ AtomSpacePublisherModule::AtomSpacePublisherModule(CogServer& cs) : Module(cs)
 	_avchange_connection = 0;
 	_add_af_connection = 0;
 	_remove_af_connection = 0;
+	sequence = 0;
+	removingLimit = MIN_REMOVING_LIMIT;
+	typeFilter = nullptr;
 	enableSignals();
 
+	context = nullptr;
+	compressor = nullptr;
+	ring = nullptr;
+	trace = false;
+	dictionaryTraining = false;
+
 	do_publisherEnableSignals_register();
 	do_publisherDisableSignals_register();
+	do_publisherCompressionStats_register();
+	do_publisherSnapshot_register();
 }
 
 void AtomSpacePublisherModule::init(void)
 {
 	logger().info("Initializing AtomSpacePublisherModule.");
+	trace = config().get_bool("ZMQ_EVENT_TRACE", false);
+	std::string types = config().get("ZMQ_EVENT_TYPES", "");
+	if (not types.empty())
+	{
+		{
+			std::lock_guard<std::mutex> lock(typeFilterMutex);
+			typeNames = types;
+		}
+		// Throws for unknown type names, leaving the filter off
+		resolveTypeFilter(TypeTable::current());
+		logger().info("[AtomSpacePublisherModule] only publishing events "
+		              "for %s", types.c_str());
+	}
+	InitCompression();
+	InitSharedMemory();
 	InitZeroMQ();
 }
 
@@ -86,15 +117,32 @@ AtomSpacePublisherModule::~AtomSpacePublisherModule()
 
 	disableSignals();
 
-	// Shut down the ZeroMQ proxy loop
-	message_t message;
-	message.type = "CONTROL";
-	message.payload = "TERMINATE";
-	queue.push(message);
-	context->close();
+	// Shut down the ZeroMQ proxy loop, and wait for it to publish what
+	// it still holds. A dictionary being trained is waited for, since
+	// its task hands it to the queue.
+	if (proxyThread.joinable())
+	{
+		while (dictionaryTraining)
+			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+		message_t message;
+		message.type = "CONTROL";
+		message.payload = "TERMINATE";
+		queue.push(message);
+		proxyThread.join();
+	}
+	if (nullptr != context)
+	{
+		context->close();
+		delete context;
+	}
+	delete compressor;
+	delete ring;
 
 	do_publisherEnableSignals_unregister();
 	do_publisherDisableSignals_unregister();
+	do_publisherCompressionStats_unregister();
+	do_publisherSnapshot_unregister();
 }
 
 void AtomSpacePublisherModule::enableSignals()
@@ -122,14 +170,433 @@ void AtomSpacePublisherModule::enableSignals()
 	}
 }
 
+void AtomSpacePublisherModule::disableSignals()
+{
+	if (0 < _add_atom_connection)
+	{
+		_add_atom_signal->disconnect(_add_atom_connection);
+		_add_atom_connection = 0;
+	}
+	if (0 < _remove_atom_connection)
+	{
+		_remove_atom_signal->disconnect(_remove_atom_connection);
+		_remove_atom_connection = 0;
+	}
+	if (0 < _tvchange_connection)
+	{
+		_tvchange_signal->disconnect(_tvchange_connection);
+		_tvchange_connection = 0;
+	}
+}
+
+void AtomSpacePublisherModule::InitCompression()
+{
+	// Uncompressed is the default: local consumers gain nothing from
+	// paying the CPU cost.
+	EventCompressor::Codec codec = EventCompressor::parseCodec(
+		config().get("ZMQ_EVENT_COMPRESSION", "none"));
+	if (EventCompressor::NONE == codec)
+		return;
+
+	compressor = new EventCompressor(codec,
+		config().get_int("ZMQ_EVENT_COMPRESSION_LEVEL", 0));
+	batchSize = config().get_int("ZMQ_EVENT_BATCH_SIZE",
+	                             DEFAULT_BATCH_SIZE);
+	batchDelay = config().get_int("ZMQ_EVENT_BATCH_DELAY",
+	                              DEFAULT_BATCH_DELAY) * 1000000ULL;
+	dictionarySamples = config().get_int("ZMQ_EVENT_DICTIONARY_SAMPLES",
+	                                     DEFAULT_DICTIONARY_SAMPLES);
+	dictionarySize = config().get_int("ZMQ_EVENT_DICTIONARY_SIZE",
+	                                  DEFAULT_DICTIONARY_SIZE);
+	dictionaryInterval = config().get_int("ZMQ_EVENT_DICTIONARY_INTERVAL",
+	                                      DEFAULT_DICTIONARY_INTERVAL);
+
+	// A pre-trained dictionary may be supplied; otherwise one is trained
+	// from the first messages that are published.
+	std::string dictFile = config().get("ZMQ_EVENT_DICTIONARY", "");
+	if (not dictFile.empty())
+	{
+		std::ifstream in(dictFile, std::ios::binary);
+		if (not in)
+			throw RuntimeException(TRACE_INFO,
+				"Cannot read event dictionary %s", dictFile.c_str());
+		std::stringstream ss;
+		ss << in.rdbuf();
+		compressor->setDictionary(ss.str());
+	}
+
+	logger().info("[AtomSpacePublisherModule] compressing events with %s, "
+	              "level %d, batch size %d, delay %d ms",
+	              EventCompressor::codecName(codec),
+	              compressor->level(), batchSize,
+	              (int) (batchDelay / 1000000));
+}
+
+void AtomSpacePublisherModule::InitSharedMemory()
+{
+	std::string name = config().get("EVENT_SHM_NAME", "");
+	if (name.empty())
+		return;
+
+	size_t size = config().get_int("EVENT_SHM_SIZE", DEFAULT_SHM_SIZE);
+	ring = new EventRing(name, size);
+	logger().info("[AtomSpacePublisherModule] publishing events to "
+	              "shared memory ring %s", name.c_str());
+}
+
+void AtomSpacePublisherModule::InitZeroMQ()
+{
+	context = new zmq::context_t(1);
+
+	proxyThread = std::thread(&AtomSpacePublisherModule::proxy, this);
+}
+
+// The payload is a JSON object, as written by Json::FastWriter; the
+// trace is added as one more member.
+static std::string withTrace(const std::string& payload,
+                             const Json::Value& trace)
+{
+	Json::FastWriter fw;
+	std::string member = fw.write(trace);
+	member.pop_back();
+
+	std::string json(payload);
+	json.insert(json.rfind('}'), ",\"trace\":" + member);
+	return json;
+}
+
+void AtomSpacePublisherModule::proxy()
+{
+	zmq::socket_t publisher(*context, ZMQ_PUB);
+	publisher.setsockopt(ZMQ_SNDHWM, &HWM, sizeof(HWM));
+
+	std::string endpoint;
+	if (config().get_bool("ZMQ_EVENT_USE_PUBLIC_IP"))
+		endpoint = "tcp://*:";
+	else
+		endpoint = "tcp://127.0.0.1:";
+	endpoint += config()["ZMQ_EVENT_PORT"];
+	publisher.bind(endpoint.c_str());
+
+	// Co-located subscribers can skip the TCP stack entirely.
+	std::string ipc = config().get("ZMQ_EVENT_IPC_ENDPOINT", "");
+	if (not ipc.empty())
+		publisher.bind(ipc.c_str());
+	std::string inproc = config().get("ZMQ_EVENT_INPROC_ENDPOINT", "");
+	if (not inproc.empty())
+		publisher.bind(inproc.c_str());
+
+	// Pending batches, one per message type, so that topic filtering
+	// keeps working on the subscriber side.
+	std::map<std::string, event_batch_t> batches;
+
+	// The workers finish serializing in any order; messages wait here
+	// until every lower-numbered one has been published.
+	std::map<uint64_t, message_t> pending;
+	uint64_t next = 1;
+
+	while (true)
+	{
+		message_t message;
+		queue.pop(message);
+
+		if (message.type == "CONTROL" && message.payload == "TERMINATE")
+		{
+			// Events still being serialized are lost anyway; publish the
+			// rest, in order, across the gaps.
+			for (const auto& p : pending)
+				publishMessage(publisher, batches, p.second);
+			if (nullptr != compressor)
+				publishBatches(publisher, batches, true);
+			break;
+		}
+
+		// A newly trained dictionary, from trainDictionary()
+		if (message.type == "DICTIONARY")
+		{
+			installDictionary(publisher, message.payload);
+			continue;
+		}
+
+		uint64_t seq = message.sequence;
+		pending.emplace(seq, std::move(message));
+		while (not pending.empty() and pending.begin()->first == next)
+		{
+			publishMessage(publisher, batches, pending.begin()->second);
+			pending.erase(pending.begin());
+			next++;
+		}
+
+		// Only hold messages back while more are already waiting; an
+		// idle queue means batching would just add latency.
+		if (nullptr != compressor)
+			publishBatches(publisher, batches, queue.empty());
+	}
+
+	publisher.close();
+}
+
+void AtomSpacePublisherModule::publishMessage(zmq::socket_t& publisher,
+                                              std::map<std::string, event_batch_t>& batches,
+                                              const message_t& message)
+{
+	// Its number was used, but there is nothing to publish.
+	if (message.payload.empty()) return;
+
+	// Local readers get every message uncompressed, as soon as it
+	// is available.
+	if (nullptr != ring and not ring->publish(message.type, message.payload))
+		logger().warn("[AtomSpacePublisherModule] %s message of %zu "
+		              "bytes is too large for the shared memory ring",
+		              message.type.c_str(), message.payload.size());
+
+	if (nullptr == compressor)
+	{
+		s_sendmore(publisher, message.type);
+		if (trace)
+			s_send(publisher, withTrace(message.payload,
+				traceToJSON(message, monotonicTime())));
+		else
+			s_send(publisher, message.payload);
+		return;
+	}
+
+	if (not compressor->trained() and not dictionaryTraining
+	    and 0 < dictionarySamples)
+	{
+		dictionarySampleBuf.push_back(message.payload);
+		if ((int) dictionarySampleBuf.size() >= dictionarySamples)
+			trainDictionary();
+	}
+
+	event_batch_t& batch = batches[message.type];
+	if (0 == batch.count)
+		batch.first_ns = monotonicTime();
+	EventCompressor::appendRecord(batch.records, message.payload);
+	if (trace)
+		batch.trace.append(traceToJSON(message, 0));
+	if ((int) ++batch.count >= batchSize)
+		publishBatch(publisher, message.type, batch);
+}
+
+void AtomSpacePublisherModule::publishBatches(zmq::socket_t& publisher,
+                                              std::map<std::string, event_batch_t>& batches,
+                                              bool all)
+{
+	// Under sustained load the queue never runs empty, so a batch of a
+	// rare event type would never fill up; it is flushed once it has
+	// waited for batchDelay.
+	uint64_t now = monotonicTime();
+	for (auto& b : batches)
+		if (all or (0 < b.second.count and now - b.second.first_ns >= batchDelay))
+			publishBatch(publisher, b.first, b.second);
+}
+
+void AtomSpacePublisherModule::publishBatch(zmq::socket_t& publisher,
+                                            const std::string& type,
+                                            event_batch_t& batch)
+{
+	if (0 == batch.count) return;
+
+	std::string blob;
+	uint64_t nbatches;
+	{
+		std::lock_guard<std::mutex> lock(statsMutex);
+		blob = compressor->compress(batch.records, batch.count);
+		nbatches = compressor->stats().batches;
+	}
+
+	Json::Value header;
+	header["codec"] = EventCompressor::codecName(compressor->codec());
+	header["dictionary"] = compressor->dictionaryId();
+	header["count"] = (Json::UInt64) batch.count;
+	header["size"] = (Json::UInt64) batch.records.size();
+	if (trace)
+	{
+		// Every message in the batch leaves now.
+		Json::UInt64 sent = monotonicTime();
+		for (Json::Value& t : batch.trace)
+			t["sent"] = sent;
+		header["trace"] = batch.trace;
+	}
+	Json::FastWriter fw;
+
+	// Compressed batches go out on their own topics, e.g. "zstd:add",
+	// so that subscribers expecting plain JSON never see them.
+	s_sendmore(publisher, header["codec"].asString() + ":" + type);
+	s_sendmore(publisher, fw.write(header));
+	s_send(publisher, blob);
+
+	batch.records.clear();
+	batch.count = 0;
+	batch.trace.clear();
+
+	// Late joiners need the dictionary too; re-advertise it regularly.
+	if (compressor->trained() and 0 < dictionaryInterval
+	    and 0 == nbatches % dictionaryInterval)
+		publishDictionary(publisher);
+}
+
+void AtomSpacePublisherModule::trainDictionary()
+{
+	std::vector<std::string> samples;
+	samples.swap(dictionarySampleBuf);
+	size_t size = dictionarySize;
+	dictionaryTraining = true;
+
+	tbb_enqueue_lambda([this, samples, size] {
+		message_t message;
+		message.type = "DICTIONARY";
+		message.payload = EventCompressor::trainDictionary(samples, size);
+		queue.push(message);
+	});
+}
+
+void AtomSpacePublisherModule::installDictionary(zmq::socket_t& publisher,
+                                                 const std::string& dict)
+{
+	{
+		std::lock_guard<std::mutex> lock(statsMutex);
+		compressor->setDictionary(dict);
+	}
+	// Without a dictionary, sampling starts over.
+	dictionaryTraining = false;
+	if (compressor->trained())
+		publishDictionary(publisher);
+}
+
+void AtomSpacePublisherModule::publishDictionary(zmq::socket_t& publisher)
+{
+	Json::Value header;
+	header["codec"] = EventCompressor::codecName(compressor->codec());
+	header["dictionary"] = compressor->dictionaryId();
+	header["size"] = (Json::UInt64) compressor->dictionary().size();
+	Json::FastWriter fw;
+
+	s_sendmore(publisher, "dictionary");
+	s_sendmore(publisher, fw.write(header));
+	s_send(publisher, compressor->dictionary());
+}
+
+uint64_t AtomSpacePublisherModule::monotonicTime()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+event_time_t AtomSpacePublisherModule::signalTime()
+{
+	event_time_t t;
+	t.sequence = ++sequence;
+	t.wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+	t.monotonic_ns = monotonicTime();
+	return t;
+}
+
+Json::Value AtomSpacePublisherModule::traceToJSON(const message_t& message,
+                                                  uint64_t sent_ns)
+{
+	Json::Value json(Json::objectValue);
+	json["signal"] = (Json::UInt64) message.signal_ns;
+	json["started"] = (Json::UInt64) message.started_ns;
+	json["serialized"] = (Json::UInt64) message.serialized_ns;
+	if (0 != sent_ns)
+		json["sent"] = (Json::UInt64) sent_ns;
+	return json;
+}
+
+void AtomSpacePublisherModule::sendMessage(std::string messageType,
+                                           std::string payload,
+                                           const event_time_t& t,
+                                           uint64_t started_ns)
+{
+	message_t message;
+	message.type = messageType;
+	message.payload = payload;
+	message.sequence = t.sequence;
+	message.signal_ns = t.monotonic_ns;
+	message.started_ns = started_ns;
+	message.serialized_ns = monotonicTime();
+	queue.push(message);
+}
+
+const type_filter_t*
+AtomSpacePublisherModule::resolveTypeFilter(const TypeTable& table)
+{
+	std::lock_guard<std::mutex> lock(typeFilterMutex);
+	const type_filter_t* filter = typeFilter.load(std::memory_order_acquire);
+	if (nullptr != filter and filter->table == &table)
+		return filter;
+
+	typeFilters.emplace_back(new type_filter_t{&table,
+	                                           table.subtypes(typeNames)});
+	filter = typeFilters.back().get();
+	typeFilter.store(filter, std::memory_order_release);
+	return filter;
+}
+
+const TypeSet* AtomSpacePublisherModule::publishedTypes()
+{
+	const type_filter_t* filter = typeFilter.load(std::memory_order_acquire);
+	if (nullptr == filter) return nullptr;
+
+	// Until types are added, this is a pointer comparison.
+	const TypeTable& table = TypeTable::current();
+	if (filter->table != &table)
+		filter = resolveTypeFilter(table);
+	return &filter->types;
+}
+
+void AtomSpacePublisherModule::atomAddSignal(Handle h)
+{
+	if (not publishes(h->get_type())) return;
+	enqueue("add", [=](const event_time_t& t) {
+		return atomMessage(atomToJSON(h), t);
+	});
+}
+
+void AtomSpacePublisherModule::atomRemoveSignal(AtomPtr atom)
+{
+	if (not publishes(atom->get_type())) return;
+	Handle h(atom->get_handle());
+
+	// The signal comes before the atom is extracted, so until then a
+	// snapshot could hold an atom whose remove event it claims to
+	// reflect. The atom is recorded before the event is numbered.
+	{
+		std::lock_guard<std::mutex> lock(removingMutex);
+		removing.emplace(h.get(), h);
+		if (removing.size() >= removingLimit)
+			pruneRemoving();
+	}
+
+	enqueue("remove", [=](const event_time_t& t) {
+		return atomMessage(atomToJSON(h), t);
+	});
+}
+
+// Called with removingMutex held
+void AtomSpacePublisherModule::pruneRemoving()
+{
+	for (auto it = removing.begin(); it != removing.end(); )
+	{
+		if (as->get_atom(it->second).get() != it->first)
+			it = removing.erase(it);
+		else
+			++it;
+	}
+	removingLimit = std::max(MIN_REMOVING_LIMIT, 2 * removing.size());
+}
+
 void AtomSpacePublisherModule::AVChangedSignal(const Handle& h,
 		                     const AttentionValuePtr& av_old,
 		                     const AttentionValuePtr& av_new)
 {
-	tbb_enqueue_lambda([=] {
-		sendMessage("avChanged", avMessage(atomToJSON(h),
-		                         avToJSON(av_old),
-		                         avToJSON(av_new)));
+	if (not publishes(h->get_type())) return;
+	enqueue("avChanged", [=](const event_time_t& t) {
+		return avMessage(atomToJSON(h), avToJSON(av_old),
+		                 avToJSON(av_new), t);
 	});
 }
 
@@ -137,10 +604,10 @@ void AtomSpacePublisherModule::TVChangedSignal(const Handle& h,
                                                const TruthValuePtr& tv_old,
                                                const TruthValuePtr& tv_new)
 {
-	tbb_enqueue_lambda([=] {
-		sendMessage("tvChanged", tvMessage(atomToJSON(h),
-		                         tvToJSON(tv_old),
-		                         tvToJSON(tv_new)));
+	if (not publishes(h->get_type())) return;
+	enqueue("tvChanged", [=](const event_time_t& t) {
+		return tvMessage(atomToJSON(h), tvToJSON(tv_old),
+		                 tvToJSON(tv_new), t);
 	});
 }
 
@@ -148,10 +615,10 @@ void AtomSpacePublisherModule::addAFSignal(const Handle& h,
                                            const AttentionValuePtr& av_old,
                                            const AttentionValuePtr& av_new)
 {
-	tbb_enqueue_lambda([=] {
-		sendMessage("addAF", avMessage(atomToJSON(h),
-		                     avToJSON(av_old),
-		                     avToJSON(av_new)));
+	if (not publishes(h->get_type())) return;
+	enqueue("addAF", [=](const event_time_t& t) {
+		return avMessage(atomToJSON(h), avToJSON(av_old),
+		                 avToJSON(av_new), t);
 	});
 }
 
@@ -159,10 +626,10 @@ void AtomSpacePublisherModule::removeAFSignal(const Handle& h,
                                               const AttentionValuePtr& av_old,
                                               const AttentionValuePtr& av_new)
 {
-	tbb_enqueue_lambda([=] {
-		sendMessage("removeAF", avMessage(atomToJSON(h),
-		                        avToJSON(av_old),
-		                        avToJSON(av_new)));
+	if (not publishes(h->get_type())) return;
+	enqueue("removeAF", [=](const event_time_t& t) {
+		return avMessage(atomToJSON(h), avToJSON(av_old),
+		                 avToJSON(av_new), t);
 	});
 }
 
@@ -171,7 +638,7 @@ Json::Value AtomSpacePublisherModule::atomToJSON(Handle h)
 {
 	// Type
 	Type type = h->get_type();
-	std::string typeNameString = nameserver().getTypeName(type);
+	const std::string& typeNameString = TypeTable::current().name(type);
 
 	// Name
 	std::string nameString;
@@ -291,39 +758,52 @@ Json::Value AtomSpacePublisherModule::tvToJSON(TruthValuePtr tvp)
 	return json;
 }
 
-std::string AtomSpacePublisherModule::atomMessage(Json::Value jsonAtom)
+void AtomSpacePublisherModule::addTimestamps(Json::Value& json,
+                                             const event_time_t& t)
+{
+	// "timestamp" is kept in seconds for existing clients.
+	json["timestamp"] = (Json::UInt64) (t.wall_ns / 1000000000ULL);
+	json["timestamp_ns"] = (Json::UInt64) t.wall_ns;
+	json["monotonic_ns"] = (Json::UInt64) t.monotonic_ns;
+	json["sequence"] = (Json::UInt64) t.sequence;
+}
+
+std::string AtomSpacePublisherModule::atomMessage(Json::Value jsonAtom,
+                                                  const event_time_t& t)
 {
 	Json::Value json;
 	json["atom"] = jsonAtom;
-	json["timestamp"] = (Json::UInt64)time(0);
+	addTimestamps(json, t);
 	Json::FastWriter fw;
 	return fw.write(json);
 }
 
 std::string AtomSpacePublisherModule::avMessage(Json::Value jsonAtom,
                                                 Json::Value jsonAVOld,
-                                                Json::Value jsonAVNew)
+                                                Json::Value jsonAVNew,
+                                                const event_time_t& t)
 {
 	Json::Value json;
 	json["handle"] = jsonAtom["handle"];
 	json["avOld"] = jsonAVOld;
 	json["avNew"] = jsonAVNew;
 	json["atom"] = jsonAtom;
-	json["timestamp"] = (Json::UInt64)time(0);
+	addTimestamps(json, t);
 	Json::FastWriter fw;
 	return fw.write(json);
 }
 
 std::string AtomSpacePublisherModule::tvMessage(Json::Value jsonAtom,
                                                 Json::Value jsonTVOld,
-                                                Json::Value jsonTVNew)
+                                                Json::Value jsonTVNew,
+                                                const event_time_t& t)
 {
 	Json::Value json;
 	json["handle"] = jsonAtom["handle"];
 	json["tvOld"] = jsonTVOld;
 	json["tvNew"] = jsonTVNew;
 	json["atom"] = jsonAtom;
-	json["timestamp"] = (Json::UInt64)time(0);
+	addTimestamps(json, t);
 	Json::FastWriter fw;
 	return fw.write(json);
 }
@@ -341,3 +821,83 @@ std::string AtomSpacePublisherModule
 	disableSignals();
 	return "AtomSpace Publisher signals have been disabled.\n";
 }
+
+std::string AtomSpacePublisherModule
+::do_publisherCompressionStats(Request *dummy, std::list<std::string> args)
+{
+	if (nullptr == compressor)
+		return "AtomSpace Publisher compression is disabled.\n";
+
+	EventCompressor::stats_t stats;
+	uint32_t dictId;
+	{
+		std::lock_guard<std::mutex> lock(statsMutex);
+		stats = compressor->stats();
+		dictId = compressor->dictionaryId();
+	}
+
+	std::ostringstream oss;
+	oss << std::fixed << std::setprecision(2);
+	oss << "codec: " << EventCompressor::codecName(compressor->codec())
+	    << " level " << compressor->level()
+	    << " batch size " << batchSize << std::endl;
+	oss << "dictionary: " << dictId << std::endl;
+	oss << "batches: " << stats.batches
+	    << " messages: " << stats.messages << std::endl;
+	oss << "bytes in: " << stats.raw_bytes
+	    << " bytes out: " << stats.compressed_bytes << std::endl;
+	if (0 < stats.compressed_bytes)
+		oss << "compression ratio: "
+		    << (double) stats.raw_bytes / stats.compressed_bytes << std::endl;
+	if (0 < stats.messages)
+		oss << "CPU per message: "
+		    << (double) stats.cpu_ns / stats.messages << " ns" << std::endl;
+	if (0 < stats.cpu_ns)
+		oss << "throughput: "
+		    << (stats.raw_bytes / 1.0e6) / (stats.cpu_ns / 1.0e9)
+		    << " MB/s" << std::endl;
+	return oss.str();
+}
+
+std::string AtomSpacePublisherModule
+::do_publisherSnapshot(Request *dummy, std::list<std::string> args)
+{
+	if (1 != args.size())
+		return "Usage: publisher-snapshot FILENAME\n";
+
+	// Every event numbered up to start has already changed the
+	// AtomSpace, except for removes, whose atoms may not have been
+	// extracted yet: those are in the removing set by then, and are left
+	// out. Events numbered up to end may or may not have been seen.
+	// Removes are only recorded for the published types, so only those
+	// types can be in the snapshot.
+	std::unordered_set<const Atom*> exclude;
+	uint64_t start;
+	{
+		std::lock_guard<std::mutex> lock(removingMutex);
+		pruneRemoving();
+		start = sequence.load();
+		for (const auto& r : removing)
+			exclude.insert(r.first);
+	}
+
+	AtomSpaceSnapshot snapshot;
+	snapshot.capture(*as, exclude, publishedTypes());
+	uint64_t end = sequence.load();
+	snapshot.setSequence(start, end);
+
+	try
+	{
+		snapshot.write(args.front());
+	}
+	catch (const RuntimeException& e)
+	{
+		return std::string("Error: ") + e.get_message() + "\n";
+	}
+
+	std::ostringstream oss;
+	oss << "Snapshot of " << snapshot.size() << " atoms at sequence "
+	    << start << " (up to " << end << ") written to "
+	    << args.front() << std::endl;
+	return oss.str();
+}
@@ -25,7 +25,15 @@
 #ifndef _OPENCOG_ATOMSPACE_PUBLISHER_MODULE_H
 #define _OPENCOG_ATOMSPACE_PUBLISHER_MODULE_H
 
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
 #include <lib/zmq/zhelpers.hpp>
 
 #include <json/json.h>
@@ -33,12 +41,17 @@
 #include <tbb/task.h>
 #include <tbb/concurrent_queue.h>
 
+#include <opencog/util/Logger.h>
 #include <opencog/util/sigslot.h>
 
 #include <opencog/cogserver/server/Module.h>
 #include <opencog/cogserver/server/CogServer.h>
 #include <opencog/attentionbank/bank/AttentionBank.h>
 
+#include "EventCompressor.h"
+#include "EventRing.h"
+#include "TypeTable.h"
+
 #ifndef TBB_H
 #define TBB_H
 
@@ -108,19 +121,72 @@ class CogServer;
  *   - Tasks serialize the atomspace event into a standard JSON message format
  *   - Serialized output is forwarded to a TBB concurrent queue
  *   - Proxy accesses the concurrent queue using a blocking pop operation to
- *     demultiplex messages and forward them to the ZeroMQ publisher socket
+ *     demultiplex messages and forward them to the ZeroMQ publisher socket,
+ *     putting them back in signal order first
+ *   - Optionally, the proxy groups messages of the same type into batches
+ *     and compresses each batch with lz4 or zstd (see EventCompressor)
+ *   - Besides TCP, the publisher socket may also be bound to ipc:// and
+ *     inproc:// endpoints, and messages may be copied into a shared memory
+ *     ring (see EventRing) for subscribers on the same host
+ *   - Every event is numbered in the signal handler; snapshots of the
+ *     AtomSpace (see AtomSpaceSnapshot) are tagged with the same numbers,
+ *     so that clients know which events to apply on top of a snapshot
  **/
 class AtomSpacePublisherModule;
 typedef std::shared_ptr<AtomSpacePublisherModule> AtomSpacePublisherModulePtr;
 
+/**
+ * When an event happened. Both clocks are read once, in the signal
+ * handler, so that the timestamps do not depend on how long the event
+ * waited to be serialized. All values are nanoseconds.
+ */
+struct event_time_t {
+	uint64_t sequence;       // event number, in signal order
+	uint64_t wall_ns;        // system clock, comparable across hosts
+	uint64_t monotonic_ns;   // steady clock, comparable on the same host
+};
+
 struct message_t {
 	std::string type;
-	std::string payload;
+	std::string payload;        // empty if the event could not be serialized
+	uint64_t sequence = 0;      // 0 for control messages
+
+	// Pipeline stage timestamps on the steady clock, in nanoseconds.
+	uint64_t signal_ns = 0;
+	uint64_t started_ns = 0;
+	uint64_t serialized_ns = 0;
+};
+
+// The subtypes of the ZMQ_EVENT_TYPES types, in one TypeTable
+struct type_filter_t {
+	const TypeTable* table;
+	TypeSet types;
+};
+
+// Messages of one type waiting to be compressed and published together
+struct event_batch_t {
+	std::string records;
+	size_t count = 0;
+	uint64_t first_ns = 0;   // steady clock, when the first was added
+	Json::Value trace = Json::Value(Json::arrayValue);
 };
 
 // High water mark for publisher socket
 const int HWM = 10000000;
 
+// Default size of the optional shared memory ring
+const size_t DEFAULT_SHM_SIZE = 64 * 1024 * 1024;
+
+// Defaults for the optional batch compression
+const int DEFAULT_BATCH_SIZE = 64;
+const int DEFAULT_BATCH_DELAY = 10;   // milliseconds
+const int DEFAULT_DICTIONARY_SAMPLES = 1000;
+const int DEFAULT_DICTIONARY_SIZE = 16384;
+const int DEFAULT_DICTIONARY_INTERVAL = 1000;
+
+// Removed atoms tracked before the first check for extracted ones
+const size_t MIN_REMOVING_LIMIT = 1024;
+
 class AtomSpacePublisherModule : public Module
 {
 private:
@@ -153,17 +219,112 @@ private:
 
 		// ZeroMQ
 		zmq::context_t * context;
+		std::thread proxyThread;
 		void InitZeroMQ();
 		void proxy();
-
-		void sendMessage(std::string messageType, std::string payload);
-		std::string atomMessage(Json::Value jsonAtom);
+		void publishMessage(zmq::socket_t& publisher,
+		                    std::map<std::string, event_batch_t>& batches,
+		                    const message_t& message);
+
+		// Shared memory transport; written by the proxy thread only
+		EventRing* ring;
+		void InitSharedMemory();
+
+		// Batch compression; only used from the proxy thread, except
+		// for the stats, which are read by the CogServer command.
+		EventCompressor* compressor;
+		int batchSize;
+		uint64_t batchDelay;   // nanoseconds
+		int dictionarySamples;
+		int dictionarySize;
+		int dictionaryInterval;
+		std::mutex statsMutex;
+		void InitCompression();
+
+		// Dictionary training takes a while, so it runs on a TBB worker;
+		// the proxy collects the samples, and installs the dictionary
+		// when it comes back through the queue.
+		std::vector<std::string> dictionarySampleBuf;
+		std::atomic<bool> dictionaryTraining;
+		void trainDictionary();
+		void installDictionary(zmq::socket_t& publisher,
+		                       const std::string& dict);
+		void publishBatch(zmq::socket_t& publisher,
+		                  const std::string& type,
+		                  event_batch_t& batch);
+		void publishBatches(zmq::socket_t& publisher,
+		                    std::map<std::string, event_batch_t>& batches,
+		                    bool all);
+		void publishDictionary(zmq::socket_t& publisher);
+
+		// Only atoms of these types (and their subtypes) are published;
+		// all atoms when there is no filter. It is resolved again whenever
+		// TypeTable::current() changes, since new types may be subtypes
+		// of the named ones. Like the tables, filters are never freed,
+		// so the signal handlers can use them without locking.
+		std::string typeNames;
+		std::atomic<const type_filter_t*> typeFilter;
+		std::mutex typeFilterMutex;
+		std::vector<std::unique_ptr<const type_filter_t>> typeFilters;
+		const type_filter_t* resolveTypeFilter(const TypeTable& table);
+		const TypeSet* publishedTypes();
+		bool publishes(Type t)
+		{
+			const TypeSet* types = publishedTypes();
+			return nullptr == types or types->contains(t);
+		}
+
+		// Stage timestamps
+		bool trace;
+		std::atomic<uint64_t> sequence;
+		event_time_t signalTime();
+		static uint64_t monotonicTime();
+		Json::Value traceToJSON(const message_t& message, uint64_t sent_ns);
+
+		// Atoms whose remove event has been numbered, but which may not
+		// have been extracted yet, keyed by address; snapshots leave them
+		// out. Entries are dropped once the atom has left the AtomSpace.
+		std::mutex removingMutex;
+		std::unordered_map<const Atom*, Handle> removing;
+		size_t removingLimit;
+		void pruneRemoving();
+
+		// Numbers the event, and serializes it on a TBB worker. The proxy
+		// publishes events in sequence order, so every number must reach
+		// it, even when serialization fails.
+		template<typename F>
+		void enqueue(const std::string& messageType, F serialize)
+		{
+			event_time_t t = signalTime();
+			tbb_enqueue_lambda([=] {
+				uint64_t started = monotonicTime();
+				std::string payload;
+				try
+				{
+					payload = serialize(t);
+				}
+				catch (const std::exception& e)
+				{
+					logger().error("[AtomSpacePublisherModule] cannot "
+					               "serialize %s event %llu: %s",
+					               messageType.c_str(),
+					               (unsigned long long) t.sequence, e.what());
+				}
+				sendMessage(messageType, payload, t, started);
+			});
+		}
+		void sendMessage(std::string messageType, std::string payload,
+		                 const event_time_t& t, uint64_t started_ns);
+		void addTimestamps(Json::Value& json, const event_time_t& t);
+		std::string atomMessage(Json::Value jsonAtom, const event_time_t& t);
 		std::string avMessage(Json::Value jsonAtom,
 		                      Json::Value jsonAVOld,
-		                      Json::Value jsonAVNew);
+		                      Json::Value jsonAVNew,
+		                      const event_time_t& t);
 		std::string tvMessage(Json::Value jsonAtom,
 		                      Json::Value jsonTVOld,
-							  Json::Value jsonTVNew);
+		                      Json::Value jsonTVNew,
+		                      const event_time_t& t);
 		Json::Value atomToJSON(Handle h);
 		Json::Value tvToJSON(TruthValuePtr tv);
 		Json::Value avToJSON(AttentionValuePtr av);
@@ -181,6 +342,23 @@ private:
 		                    "Usage: publisher-disable-signals",
 		                    false, false)
 
+		DECLARE_CMD_REQUEST(AtomSpacePublisherModule, "publisher-compression-stats",
+		                    do_publisherCompressionStats,
+		                    "Show the compression ratio and CPU cost of event batches",
+		                    "Usage: publisher-compression-stats",
+		                    false, false)
+
+		DECLARE_CMD_REQUEST(AtomSpacePublisherModule, "publisher-snapshot",
+		                    do_publisherSnapshot,
+		                    "Write a snapshot of the AtomSpace to a file",
+		                    "Usage: publisher-snapshot FILENAME\n\n"
+		                    "The snapshot is in the columnar format described in\n"
+		                    "opencog/events/SnapshotFormat.h, tagged with the\n"
+		                    "sequence number of the last event it reflects.\n"
+		                    "Atoms that are being removed, and atoms of types\n"
+		                    "that are not published, are left out.",
+		                    false, false)
+
 public:
 		AtomSpacePublisherModule(CogServer&);
 		virtual ~AtomSpacePublisherModule();
@@ -189,6 +367,13 @@ public:
 		static const char *id(void);
 		virtual void init(void);
 
+		/**
+		 * The ZeroMQ context of the publisher socket. Subscribers in the
+		 * CogServer process must use it to connect to the inproc://
+		 * endpoint.
+		 */
+		zmq::context_t& getContext() { return *context; }
+
 		void atomAddSignal(Handle h);
 		void atomRemoveSignal(AtomPtr atom);
 		void AVChangedSignal(const Handle& h,
@@ -0,0 +1,236 @@
+/*
+ * opencog/events/AtomSpaceSnapshot.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+#include <opencog/util/exceptions.h>
+#include <opencog/atoms/base/Link.h>
+#include <opencog/attentionbank/bank/AttentionBank.h>
+
+#include "AtomSpaceSnapshot.h"
+#include "TypeTable.h"
+
+using namespace opencog;
+
+static inline uint64_t align8(uint64_t n)
+{
+	return (n + 7) & ~(uint64_t) 7;
+}
+
+AtomSpaceSnapshot::AtomSpaceSnapshot()
+	: _sequence(0), _sequence_end(0), _wall_ns(0)
+{
+	_name_offsets.push_back(0);
+	_outgoing_offsets.push_back(0);
+}
+
+size_t AtomSpaceSnapshot::capture(const AtomSpace& as,
+                                  const std::unordered_set<const Atom*>& exclude,
+                                  const TypeSet* types)
+{
+	_wall_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::system_clock::now().time_since_epoch()).count();
+
+	HandleSeq atoms;
+	as.get_handles_by_type(atoms, ATOM, true);
+
+	_rows.reserve(atoms.size());
+	_types.reserve(atoms.size());
+	_handles.reserve(atoms.size());
+	_name_offsets.reserve(atoms.size() + 1);
+	_outgoing_offsets.reserve(atoms.size() + 1);
+	_tv_types.reserve(atoms.size());
+	_tv_mean.reserve(atoms.size());
+	_tv_confidence.reserve(atoms.size());
+	_tv_count.reserve(atoms.size());
+	_av_sti.reserve(atoms.size());
+	_av_lti.reserve(atoms.size());
+	_av_vlti.reserve(atoms.size());
+
+	for (const Handle& h : atoms)
+		if (0 == exclude.count(h.get())
+		    and (nullptr == types or types->contains(h->get_type())))
+			add(h);
+
+	// Only needed while capturing
+	_rows.clear();
+	return size();
+}
+
+uint32_t AtomSpaceSnapshot::add(const Handle& h)
+{
+	auto it = _rows.find(h);
+	if (_rows.end() != it)
+		return it->second;
+
+	// The outgoing atoms get their rows first. A link added after the
+	// AtomSpace was listed may also bring in atoms that were not listed.
+	std::vector<uint32_t> outgoing;
+	if (h->is_link())
+		for (const Handle& o : h->getOutgoingSet())
+			outgoing.push_back(add(o));
+
+	uint32_t row = _types.size();
+	_rows[h] = row;
+
+	_types.push_back(h->get_type());
+	_handles.push_back(h.value());
+
+	if (h->is_node())
+		_names += h->get_name();
+	_name_offsets.push_back(_names.size());
+
+	_outgoing.insert(_outgoing.end(), outgoing.begin(), outgoing.end());
+	_outgoing_offsets.push_back(_outgoing.size());
+
+	TruthValuePtr tv = h->getTruthValue();
+	_tv_types.push_back(tv->get_type());
+	_tv_mean.push_back(tv->get_mean());
+	_tv_confidence.push_back(tv->get_confidence());
+	_tv_count.push_back(tv->get_count());
+
+	AttentionValuePtr av = get_av(h);
+	_av_sti.push_back(av->getSTI());
+	_av_lti.push_back(av->getLTI());
+	_av_vlti.push_back(av->getVLTI() != 0 ? 1 : 0);
+
+	return row;
+}
+
+void AtomSpaceSnapshot::setSequence(uint64_t sequence, uint64_t sequence_end)
+{
+	_sequence = sequence;
+	_sequence_end = sequence_end;
+}
+
+namespace {
+struct column_t
+{
+	snapshot_column_t id;
+	uint32_t width;
+	const void* data;
+	uint64_t size;
+};
+
+template<typename T>
+column_t column(snapshot_column_t id, const std::vector<T>& v)
+{
+	return column_t{id, sizeof(T), v.data(), v.size() * sizeof(T)};
+}
+}
+
+void AtomSpaceSnapshot::write(std::ostream& out) const
+{
+	const TypeTable& types = TypeTable::current();
+	std::string typeNames;
+	for (Type t = 0; t < types.size(); t++)
+	{
+		typeNames += types.name(t);
+		typeNames += '\0';
+	}
+
+	std::vector<column_t> columns = {
+		{SNAPSHOT_TYPE_NAMES, 1, typeNames.data(), typeNames.size()},
+		column(SNAPSHOT_TYPES, _types),
+		column(SNAPSHOT_HANDLES, _handles),
+		column(SNAPSHOT_NAME_OFFSETS, _name_offsets),
+		{SNAPSHOT_NAMES, 1, _names.data(), _names.size()},
+		column(SNAPSHOT_OUTGOING_OFFSETS, _outgoing_offsets),
+		column(SNAPSHOT_OUTGOING, _outgoing),
+		column(SNAPSHOT_TV_TYPES, _tv_types),
+		column(SNAPSHOT_TV_MEAN, _tv_mean),
+		column(SNAPSHOT_TV_CONFIDENCE, _tv_confidence),
+		column(SNAPSHOT_TV_COUNT, _tv_count),
+		column(SNAPSHOT_AV_STI, _av_sti),
+		column(SNAPSHOT_AV_LTI, _av_lti),
+		column(SNAPSHOT_AV_VLTI, _av_vlti),
+	};
+
+	snapshot_header_t header;
+	memset(&header, 0, sizeof(header));
+	header.magic = SNAPSHOT_MAGIC;
+	header.version = SNAPSHOT_VERSION;
+	header.sections = columns.size();
+	header.atoms = size();
+	header.sequence = _sequence;
+	header.sequence_end = _sequence_end;
+	header.wall_ns = _wall_ns;
+
+	std::vector<snapshot_section_t> table(columns.size());
+	uint64_t offset = align8(sizeof(header)
+	                         + columns.size() * sizeof(snapshot_section_t));
+	for (size_t i = 0; i < columns.size(); i++)
+	{
+		table[i].id = columns[i].id;
+		table[i].width = columns[i].width;
+		table[i].offset = offset;
+		table[i].size = columns[i].size;
+		offset = align8(offset + columns[i].size);
+	}
+
+	static const char zeros[8] = {0};
+	uint64_t written = sizeof(header) + table.size() * sizeof(table[0]);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	out.write(reinterpret_cast<const char*>(table.data()),
+	          table.size() * sizeof(table[0]));
+	for (size_t i = 0; i < columns.size(); i++)
+	{
+		out.write(zeros, table[i].offset - written);
+		out.write(static_cast<const char*>(columns[i].data), columns[i].size);
+		written = table[i].offset + columns[i].size;
+	}
+	out.write(zeros, align8(written) - written);
+	out.flush();
+
+	if (not out)
+		throw RuntimeException(TRACE_INFO, "Cannot write AtomSpace snapshot");
+}
+
+void AtomSpaceSnapshot::write(const std::string& filename) const
+{
+	// Written under a temporary name, so that a reader never maps a
+	// partial snapshot.
+	std::string tmp = filename + ".tmp";
+	{
+		std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+		if (not out)
+			throw RuntimeException(TRACE_INFO,
+				"Cannot create snapshot file %s", tmp.c_str());
+		try
+		{
+			write(out);
+		}
+		catch (const RuntimeException&)
+		{
+			remove(tmp.c_str());
+			throw;
+		}
+	}
+	if (0 != rename(tmp.c_str(), filename.c_str()))
+		throw RuntimeException(TRACE_INFO,
+			"Cannot rename snapshot file %s to %s: %s",
+			tmp.c_str(), filename.c_str(), strerror(errno));
+}
@@ -0,0 +1,102 @@
+/*
+ * opencog/events/AtomSpaceSnapshot.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_ATOMSPACE_SNAPSHOT_H
+#define _OPENCOG_ATOMSPACE_SNAPSHOT_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <opencog/atomspace/AtomSpace.h>
+
+#include "SnapshotFormat.h"
+#include "TypeTable.h"
+
+namespace opencog
+{
+
+/**
+ * Captures the atoms of an AtomSpace into columns, and writes them out
+ * in the snapshot format described in SnapshotFormat.h.
+ *
+ * Capturing reads every atom once, without locking the AtomSpace, so
+ * changes made meanwhile may or may not be included; the publisher's
+ * event sequence numbers tell clients which events to replay on top.
+ * The publisher passes the atoms it has announced as removed but that
+ * may still be in the AtomSpace, so that they are left out, and the
+ * types it publishes events for, if it filters them.
+ * Writing needs no access to the AtomSpace, and the header gives every
+ * section's size up front, so the output can be a pipe or a socket as
+ * well as a file.
+ */
+class AtomSpaceSnapshot
+{
+public:
+	AtomSpaceSnapshot();
+
+	/**
+	 * Read all the atoms of as, but those in exclude, and, if types is
+	 * given, those of other types. Atoms left out are still read when a
+	 * link that is read needs them. Returns the number of atoms.
+	 */
+	size_t capture(const AtomSpace& as,
+	               const std::unordered_set<const Atom*>& exclude = {},
+	               const TypeSet* types = nullptr);
+
+	void setSequence(uint64_t sequence, uint64_t sequence_end);
+
+	void write(std::ostream& out) const;
+	void write(const std::string& filename) const;
+
+	size_t size() const { return _types.size(); }
+
+private:
+	uint64_t _sequence;
+	uint64_t _sequence_end;
+	uint64_t _wall_ns;
+
+	std::unordered_map<Handle, uint32_t> _rows;
+
+	std::vector<uint16_t> _types;
+	std::vector<uint64_t> _handles;
+	std::vector<uint64_t> _name_offsets;
+	std::string _names;
+	std::vector<uint64_t> _outgoing_offsets;
+	std::vector<uint32_t> _outgoing;
+	std::vector<uint16_t> _tv_types;
+	std::vector<double> _tv_mean;
+	std::vector<double> _tv_confidence;
+	std::vector<double> _tv_count;
+	std::vector<double> _av_sti;
+	std::vector<double> _av_lti;
+	std::vector<uint8_t> _av_vlti;
+
+	uint32_t add(const Handle& h);
+};
+
+}
+
+#endif // _OPENCOG_ATOMSPACE_SNAPSHOT_H
@@ -0,0 +1,345 @@
+/*
+ * opencog/events/EventCompressor.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <time.h>
+
+#include <opencog/util/exceptions.h>
+#include <opencog/util/Logger.h>
+
+#ifdef HAVE_LZ4
+#include <lz4.h>
+#include <lz4hc.h>
+#endif
+
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#include <zdict.h>
+#endif
+
+#include "EventCompressor.h"
+
+using namespace opencog;
+
+struct EventCompressor::codec_state
+{
+#ifdef HAVE_ZSTD
+	ZSTD_CCtx* cctx = nullptr;
+	ZSTD_CDict* cdict = nullptr;
+	ZSTD_DCtx* dctx = nullptr;
+	std::map<uint32_t, ZSTD_DDict*> ddicts;
+
+	~codec_state()
+	{
+		ZSTD_freeCCtx(cctx);
+		ZSTD_freeCDict(cdict);
+		ZSTD_freeDCtx(dctx);
+		for (auto& dd : ddicts) ZSTD_freeDDict(dd.second);
+	}
+#endif
+};
+
+static uint64_t thread_cpu_ns()
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+EventCompressor::EventCompressor(Codec codec, int level)
+	: _codec(codec), _level(level), _dict_id(0),
+	  _state(new codec_state())
+{
+#ifdef HAVE_ZSTD
+	if (ZSTD == _codec)
+	{
+		if (0 == _level) _level = ZSTD_CLEVEL_DEFAULT;
+		_state->cctx = ZSTD_createCCtx();
+	}
+#endif
+}
+
+EventCompressor::~EventCompressor()
+{
+}
+
+EventCompressor::Codec EventCompressor::parseCodec(const std::string& name)
+{
+	if (name.empty() or name == "none" or name == "NONE")
+		return NONE;
+#ifdef HAVE_LZ4
+	if (name == "lz4" or name == "LZ4")
+		return LZ4;
+#endif
+#ifdef HAVE_ZSTD
+	if (name == "zstd" or name == "ZSTD")
+		return ZSTD;
+#endif
+	throw InvalidParamException(TRACE_INFO,
+		"Unsupported event compression codec: %s", name.c_str());
+}
+
+const char* EventCompressor::codecName(Codec codec)
+{
+	switch (codec)
+	{
+		case LZ4: return "lz4";
+		case ZSTD: return "zstd";
+		default: return "none";
+	}
+}
+
+// FNV-1a; only needs to tell a handful of dictionaries apart.
+uint32_t EventCompressor::hashDictionary(const std::string& dict)
+{
+	uint32_t h = 2166136261u;
+	for (unsigned char c : dict)
+	{
+		h ^= c;
+		h *= 16777619u;
+	}
+	// Zero means "no dictionary" on the wire.
+	return 0 == h ? 1 : h;
+}
+
+void EventCompressor::appendRecord(std::string& batch,
+                                   const std::string& record)
+{
+	uint32_t len = record.size();
+	char prefix[4] = { (char)(len & 0xff), (char)((len >> 8) & 0xff),
+	                   (char)((len >> 16) & 0xff), (char)((len >> 24) & 0xff) };
+	batch.append(prefix, 4);
+	batch.append(record);
+}
+
+std::vector<std::string> EventCompressor::splitRecords(const std::string& batch)
+{
+	std::vector<std::string> records;
+	const unsigned char* p = (const unsigned char*) batch.data();
+	size_t pos = 0;
+	while (pos + 4 <= batch.size())
+	{
+		uint32_t len = p[pos] | (p[pos+1] << 8) | (p[pos+2] << 16)
+		               | ((uint32_t)p[pos+3] << 24);
+		pos += 4;
+		if (pos + len > batch.size())
+			throw RuntimeException(TRACE_INFO,
+				"Truncated record in event batch");
+		records.emplace_back(batch, pos, len);
+		pos += len;
+	}
+	return records;
+}
+
+void EventCompressor::setDictionary(const std::string& dict)
+{
+	_dict = dict;
+	_dict_id = dict.empty() ? 0 : hashDictionary(dict);
+	_samples.clear();
+
+#ifdef HAVE_ZSTD
+	if (ZSTD == _codec)
+	{
+		ZSTD_freeCDict(_state->cdict);
+		_state->cdict = _dict.empty() ? nullptr :
+			ZSTD_createCDict(_dict.data(), _dict.size(), _level);
+	}
+#endif
+	if (0 != _dict_id)
+		addDictionary(_dict);
+}
+
+void EventCompressor::addDictionary(const std::string& dict)
+{
+	uint32_t id = hashDictionary(dict);
+	if (_known_dicts.count(id)) return;
+	_known_dicts[id] = dict;
+
+#ifdef HAVE_ZSTD
+	_state->ddicts[id] = ZSTD_createDDict(dict.data(), dict.size());
+#endif
+}
+
+bool EventCompressor::addSample(const std::string& sample, size_t wanted,
+                                size_t dict_size)
+{
+	if (trained()) return true;
+	_samples.push_back(sample);
+	if (_samples.size() < wanted) return false;
+	setDictionary(trainDictionary(_samples, dict_size));
+	return trained();
+}
+
+std::string EventCompressor::trainDictionary(const std::vector<std::string>& samples,
+                                             size_t dict_size)
+{
+#ifdef HAVE_ZSTD
+	std::string flat;
+	std::vector<size_t> sizes;
+	for (const std::string& s : samples)
+	{
+		flat.append(s);
+		sizes.push_back(s.size());
+	}
+	std::string trained(dict_size, '\0');
+	size_t rc = ZDICT_trainFromBuffer(&trained[0], trained.size(),
+		flat.data(), sizes.data(), sizes.size());
+	if (not ZDICT_isError(rc))
+	{
+		trained.resize(rc);
+		logger().info("[EventCompressor] trained a %zu byte dictionary "
+		              "from %zu messages", rc, samples.size());
+		return trained;
+	}
+	logger().warn("[EventCompressor] dictionary training failed: %s",
+	              ZDICT_getErrorName(rc));
+#endif
+
+	// Without zdict, fall back to a raw-content dictionary: the most
+	// recent samples, which lz4 and zstd both accept as a prefix.
+	std::string dict;
+	for (auto it = samples.rbegin();
+	     it != samples.rend() and dict.size() < dict_size; ++it)
+		dict.insert(0, *it);
+	if (dict.size() > dict_size)
+		dict.erase(0, dict.size() - dict_size);
+	return dict;
+}
+
+std::string EventCompressor::compress(const std::string& raw, size_t count)
+{
+	uint64_t start = thread_cpu_ns();
+	std::string out;
+
+	switch (_codec)
+	{
+#ifdef HAVE_LZ4
+	case LZ4:
+	{
+		out.resize(LZ4_compressBound(raw.size()));
+		int rc;
+		if (0 < _level)
+		{
+			LZ4_streamHC_t* stream = LZ4_createStreamHC();
+			LZ4_resetStreamHC_fast(stream, _level);
+			if (not _dict.empty())
+				LZ4_loadDictHC(stream, _dict.data(), _dict.size());
+			rc = LZ4_compress_HC_continue(stream, raw.data(), &out[0],
+			                              raw.size(), out.size());
+			LZ4_freeStreamHC(stream);
+		}
+		else
+		{
+			LZ4_stream_t* stream = LZ4_createStream();
+			if (not _dict.empty())
+				LZ4_loadDict(stream, _dict.data(), _dict.size());
+			rc = LZ4_compress_fast_continue(stream, raw.data(), &out[0],
+			                                raw.size(), out.size(), 1);
+			LZ4_freeStream(stream);
+		}
+		if (rc <= 0)
+			throw RuntimeException(TRACE_INFO, "lz4 compression failed");
+		out.resize(rc);
+		break;
+	}
+#endif
+#ifdef HAVE_ZSTD
+	case ZSTD:
+	{
+		out.resize(ZSTD_compressBound(raw.size()));
+		size_t rc = _state->cdict ?
+			ZSTD_compress_usingCDict(_state->cctx, &out[0], out.size(),
+			                         raw.data(), raw.size(), _state->cdict) :
+			ZSTD_compressCCtx(_state->cctx, &out[0], out.size(),
+			                  raw.data(), raw.size(), _level);
+		if (ZSTD_isError(rc))
+			throw RuntimeException(TRACE_INFO,
+				"zstd compression failed: %s", ZSTD_getErrorName(rc));
+		out.resize(rc);
+		break;
+	}
+#endif
+	default:
+		out = raw;
+	}
+
+	_stats.batches++;
+	_stats.messages += count;
+	_stats.raw_bytes += raw.size();
+	_stats.compressed_bytes += out.size();
+	_stats.cpu_ns += thread_cpu_ns() - start;
+	return out;
+}
+
+std::string EventCompressor::decompress(const std::string& blob,
+                                        size_t raw_size,
+                                        uint32_t dict_id) const
+{
+	const std::string* dict = nullptr;
+	if (0 != dict_id)
+	{
+		auto it = _known_dicts.find(dict_id);
+		if (it == _known_dicts.end())
+			throw RuntimeException(TRACE_INFO,
+				"Unknown event dictionary %u", dict_id);
+		dict = &it->second;
+	}
+
+	std::string out(raw_size, '\0');
+	switch (_codec)
+	{
+#ifdef HAVE_LZ4
+	case LZ4:
+	{
+		int rc = dict ?
+			LZ4_decompress_safe_usingDict(blob.data(), &out[0],
+				blob.size(), out.size(), dict->data(), dict->size()) :
+			LZ4_decompress_safe(blob.data(), &out[0],
+				blob.size(), out.size());
+		if (rc < 0 or (size_t)rc != raw_size)
+			throw RuntimeException(TRACE_INFO, "lz4 decompression failed");
+		break;
+	}
+#endif
+#ifdef HAVE_ZSTD
+	case ZSTD:
+	{
+		if (nullptr == _state->dctx)
+			_state->dctx = ZSTD_createDCtx();
+		size_t rc = dict ?
+			ZSTD_decompress_usingDDict(_state->dctx, &out[0], out.size(),
+				blob.data(), blob.size(), _state->ddicts.at(dict_id)) :
+			ZSTD_decompressDCtx(_state->dctx, &out[0], out.size(),
+				blob.data(), blob.size());
+		if (ZSTD_isError(rc) or rc != raw_size)
+			throw RuntimeException(TRACE_INFO,
+				"zstd decompression failed");
+		break;
+	}
+#endif
+	default:
+		// Only the codecs use the dictionary; without them it is just
+		// checked to be known.
+		(void) dict;
+		out = blob;
+	}
+	return out;
+}
@@ -0,0 +1,130 @@
+/*
+ * opencog/events/EventCompressor.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_EVENT_COMPRESSOR_H
+#define _OPENCOG_EVENT_COMPRESSOR_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace opencog
+{
+
+/**
+ * Per-batch compression of published AtomSpace events.
+ *
+ * A batch is a sequence of records, each one a little-endian uint32
+ * length followed by that many bytes. The whole batch is compressed as
+ * a single frame, optionally against a shared dictionary. Because all
+ * event messages share the same JSON keys, type names and TruthValue
+ * fields, a dictionary trained on a few hundred messages gives a large
+ * gain even for small batches.
+ *
+ * Dictionaries are identified by a 32-bit id, carried in the header of
+ * every compressed batch, so that subscribers can pick the right one.
+ * The same class is used on both sides: the publisher compresses, the
+ * subscribers call addDictionary() for every advertised dictionary and
+ * then decompress().
+ *
+ * Supported codecs are lz4 and zstd, depending on which libraries were
+ * found at build time. Without either, only "none" is accepted.
+ */
+class EventCompressor
+{
+public:
+	enum Codec { NONE, LZ4, ZSTD };
+
+	struct stats_t {
+		uint64_t batches = 0;
+		uint64_t messages = 0;
+		uint64_t raw_bytes = 0;
+		uint64_t compressed_bytes = 0;
+		uint64_t cpu_ns = 0;      // thread CPU time spent compressing
+	};
+
+	EventCompressor(Codec codec = NONE, int level = 0);
+	~EventCompressor();
+
+	/** Parse "none", "lz4" or "zstd"; throws InvalidParamException. */
+	static Codec parseCodec(const std::string& name);
+	static const char* codecName(Codec codec);
+
+	Codec codec() const { return _codec; }
+	int level() const { return _level; }
+
+	/** Set the dictionary used for compression. */
+	void setDictionary(const std::string& dict);
+	const std::string& dictionary() const { return _dict; }
+	uint32_t dictionaryId() const { return _dict_id; }
+
+	/** Register a dictionary advertised by a publisher. */
+	void addDictionary(const std::string& dict);
+
+	/**
+	 * Collect a training sample. Returns true once enough samples
+	 * have been seen and the dictionary was trained and installed.
+	 */
+	bool addSample(const std::string& sample, size_t wanted,
+	               size_t dict_size);
+	bool trained() const { return 0 != _dict_id; }
+
+	/**
+	 * Train a dictionary of at most dict_size bytes from samples. It
+	 * uses no compressor state, so that it can run on another thread
+	 * than the one compressing; install the result with setDictionary().
+	 */
+	static std::string trainDictionary(const std::vector<std::string>& samples,
+	                                   size_t dict_size);
+
+	std::string compress(const std::string& raw, size_t count);
+	std::string decompress(const std::string& blob, size_t raw_size,
+	                       uint32_t dict_id) const;
+
+	const stats_t& stats() const { return _stats; }
+
+	static uint32_t hashDictionary(const std::string& dict);
+	static void appendRecord(std::string& batch, const std::string& record);
+	static std::vector<std::string> splitRecords(const std::string& batch);
+
+private:
+	Codec _codec;
+	int _level;
+	std::string _dict;
+	uint32_t _dict_id;
+
+	std::vector<std::string> _samples;
+	std::map<uint32_t, std::string> _known_dicts;
+	stats_t _stats;
+
+	// Opaque codec state (compression/decompression contexts and
+	// digested dictionaries); kept out of the header so that clients
+	// do not need the codec headers installed.
+	struct codec_state;
+	std::unique_ptr<codec_state> _state;
+};
+
+}
+
+#endif // _OPENCOG_EVENT_COMPRESSOR_H
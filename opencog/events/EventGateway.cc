@@ -0,0 +1,465 @@
+/*
+ * opencog/events/EventGateway.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <mutex>
+
+#include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/signal_set.hpp>
+#include <boost/asio/strand.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/websocket.hpp>
+
+#include <json/json.h>
+#include <lib/zmq/zhelpers.hpp>
+
+#include <opencog/util/exceptions.h>
+#include <opencog/util/Logger.h>
+
+#include "EventCompressor.h"
+#include "EventGateway.h"
+
+using namespace opencog;
+
+namespace beast = boost::beast;
+namespace websocket = boost::beast::websocket;
+namespace net = boost::asio;
+using tcp = boost::asio::ip::tcp;
+
+gateway_config_t::Policy gateway_config_t::parsePolicy(const std::string& name)
+{
+	if (name == "drop-oldest") return DROP_OLDEST;
+	if (name == "drop-newest") return DROP_NEWEST;
+	if (name == "coalesce") return COALESCE;
+	throw InvalidParamException(TRACE_INFO,
+		"Unknown overflow policy: %s", name.c_str());
+}
+
+// ---------------------------------------------------------------
+
+void GatewayQueue::pop_front()
+{
+	const std::string& key = _queue.front()->key;
+	if (not key.empty())
+	{
+		auto it = _pending.find(key);
+		if (it != _pending.end() and it->second == _queue.begin())
+			_pending.erase(it);
+	}
+	_queue.pop_front();
+}
+
+void GatewayQueue::offer(const gateway_event_ptr& event)
+{
+	bool coalesce = gateway_config_t::COALESCE == _policy
+	                and not event->key.empty();
+	if (coalesce)
+	{
+		// Only the latest change to an atom is worth sending.
+		auto it = _pending.find(event->key);
+		if (it != _pending.end())
+		{
+			*it->second = event;
+			return;
+		}
+	}
+
+	if (_queue.size() >= _capacity)
+	{
+		_dropped++;
+		if (gateway_config_t::DROP_NEWEST == _policy)
+			return;
+		pop_front();
+	}
+
+	_queue.push_back(event);
+	if (coalesce)
+		_pending[event->key] = std::prev(_queue.end());
+}
+
+bool GatewayQueue::frame(std::string& out, size_t max_events)
+{
+	if (_queue.empty())
+		return false;
+
+	out = "[";
+	if (0 < _dropped)
+	{
+		out += "{\"topic\":\"dropped\",\"count\":"
+		       + std::to_string(_dropped) + "},";
+		_dropped = 0;
+	}
+	for (size_t n = 0; n < max_events and not _queue.empty(); n++)
+	{
+		out += _queue.front()->fragment;
+		out += ',';
+		pop_front();
+	}
+	out.back() = ']';
+	return true;
+}
+
+// ---------------------------------------------------------------
+
+/**
+ * One WebSocket client: its topic filter, its bounded queue of pending
+ * events and its write loop. The queue is filled by the ZeroMQ thread;
+ * everything else runs on the session's strand.
+ */
+class opencog::GatewaySession
+	: public std::enable_shared_from_this<GatewaySession>
+{
+public:
+	GatewaySession(tcp::socket&& socket, EventGateway& gateway)
+		: _ws(std::move(socket)), _gateway(gateway),
+		  _queue(gateway.config().queue_size, gateway.config().policy),
+		  _writing(false) {}
+
+	void start()
+	{
+		net::dispatch(_ws.get_executor(),
+			beast::bind_front_handler(&GatewaySession::on_run,
+			                          shared_from_this()));
+	}
+
+	void offer(const gateway_event_ptr& event);
+
+private:
+	websocket::stream<beast::tcp_stream> _ws;
+	EventGateway& _gateway;
+	beast::flat_buffer _buffer;
+	std::string _frame;
+
+	// Shared with the ZeroMQ thread
+	std::mutex _mtx;
+	std::set<std::string> _topics;      // empty: everything
+	GatewayQueue _queue;
+	bool _writing;
+
+	void on_run();
+	void on_accept(beast::error_code ec);
+	void on_read(beast::error_code ec, size_t);
+	void do_write();
+	void on_write(beast::error_code ec, size_t);
+	void close();
+};
+
+void GatewaySession::on_run()
+{
+	_ws.set_option(websocket::stream_base::timeout::suggested(
+		beast::role_type::server));
+	_ws.async_accept(beast::bind_front_handler(&GatewaySession::on_accept,
+	                                           shared_from_this()));
+}
+
+void GatewaySession::on_accept(beast::error_code ec)
+{
+	if (ec) return;
+
+	_ws.text(true);
+	_gateway.join(shared_from_this());
+	_ws.async_read(_buffer,
+		beast::bind_front_handler(&GatewaySession::on_read,
+		                          shared_from_this()));
+}
+
+void GatewaySession::close()
+{
+	_gateway.leave(this);
+}
+
+void GatewaySession::on_read(beast::error_code ec, size_t)
+{
+	if (ec)
+	{
+		close();
+		return;
+	}
+
+	// Topic filter updates: {"subscribe": [TOPIC, ...]}
+	Json::Value request;
+	Json::Reader reader;
+	std::string text = beast::buffers_to_string(_buffer.data());
+	_buffer.consume(_buffer.size());
+	if (reader.parse(text, request) and request.isObject()
+	    and request["subscribe"].isArray())
+	{
+		std::set<std::string> topics;
+		for (const Json::Value& t : request["subscribe"])
+			topics.insert(t.asString());
+
+		std::lock_guard<std::mutex> lock(_mtx);
+		_topics.swap(topics);
+	}
+
+	_ws.async_read(_buffer,
+		beast::bind_front_handler(&GatewaySession::on_read,
+		                          shared_from_this()));
+}
+
+void GatewaySession::offer(const gateway_event_ptr& event)
+{
+	std::unique_lock<std::mutex> lock(_mtx);
+	if (not _topics.empty() and 0 == _topics.count(event->topic))
+		return;
+
+	_queue.offer(event);
+	if (not _writing)
+	{
+		_writing = true;
+		lock.unlock();
+		net::post(_ws.get_executor(),
+			beast::bind_front_handler(&GatewaySession::do_write,
+			                          shared_from_this()));
+	}
+}
+
+void GatewaySession::do_write()
+{
+	{
+		std::lock_guard<std::mutex> lock(_mtx);
+		if (not _queue.frame(_frame, _gateway.config().batch_size))
+		{
+			_writing = false;
+			return;
+		}
+	}
+
+	_ws.async_write(net::buffer(_frame),
+		beast::bind_front_handler(&GatewaySession::on_write,
+		                          shared_from_this()));
+}
+
+void GatewaySession::on_write(beast::error_code ec, size_t)
+{
+	if (ec)
+	{
+		close();
+		return;
+	}
+	do_write();
+}
+
+// ---------------------------------------------------------------
+
+EventGateway::EventGateway(const gateway_config_t& config)
+	: _config(config),
+	  _ioc(0 < config.threads ? config.threads :
+	       std::max(1u, std::thread::hardware_concurrency())),
+	  _acceptor(net::make_strand(_ioc)),
+	  _running(false)
+{
+	tcp::endpoint endpoint(net::ip::make_address(_config.address),
+	                       _config.port);
+	_acceptor.open(endpoint.protocol());
+	_acceptor.set_option(net::socket_base::reuse_address(true));
+	_acceptor.bind(endpoint);
+	_acceptor.listen(net::socket_base::max_listen_connections);
+}
+
+EventGateway::~EventGateway()
+{
+	stop();
+}
+
+void EventGateway::run()
+{
+	_running = true;
+	_subscriber = std::thread(&EventGateway::subscribe, this);
+	accept();
+
+	net::signal_set signals(_ioc, SIGINT, SIGTERM);
+	signals.async_wait([this](beast::error_code, int)
+		{
+			_running = false;
+			_ioc.stop();
+		});
+
+	logger().info("[EventGateway] forwarding %s to ws://%s:%u",
+	              _config.zmq_endpoint.c_str(), _config.address.c_str(),
+	              _config.port);
+
+	unsigned nthreads = 0 < _config.threads ? _config.threads :
+	                    std::max(1u, std::thread::hardware_concurrency());
+	std::vector<std::thread> workers;
+	for (unsigned i = 1; i < nthreads; i++)
+		workers.emplace_back([this] { _ioc.run(); });
+	_ioc.run();
+	for (std::thread& w : workers)
+		w.join();
+	stop();
+}
+
+void EventGateway::stop()
+{
+	_running = false;
+	_ioc.stop();
+	if (_subscriber.joinable())
+		_subscriber.join();
+}
+
+size_t EventGateway::clients()
+{
+	std::shared_lock<std::shared_mutex> lock(_sessions_mutex);
+	return _sessions.size();
+}
+
+void EventGateway::accept()
+{
+	_acceptor.async_accept(net::make_strand(_ioc),
+		[this](beast::error_code ec, tcp::socket socket)
+		{
+			if (not ec)
+				std::make_shared<GatewaySession>(std::move(socket),
+				                                 *this)->start();
+			if (_running)
+				accept();
+		});
+}
+
+void EventGateway::join(const std::shared_ptr<GatewaySession>& session)
+{
+	std::unique_lock<std::shared_mutex> lock(_sessions_mutex);
+	_sessions.insert(session);
+}
+
+void EventGateway::leave(GatewaySession* session)
+{
+	std::unique_lock<std::shared_mutex> lock(_sessions_mutex);
+	for (auto it = _sessions.begin(); it != _sessions.end(); ++it)
+	{
+		if (it->get() == session)
+		{
+			_sessions.erase(it);
+			return;
+		}
+	}
+}
+
+gateway_event_ptr EventGateway::makeEvent(const std::string& topic,
+                                          const std::string& message)
+{
+	auto event = std::make_shared<gateway_event_t>();
+	event->topic = topic;
+
+	// Messages are already JSON; drop the writer's trailing newline.
+	size_t len = message.size();
+	while (0 < len and '\n' == message[len - 1]) len--;
+	event->fragment = "{\"topic\":\"" + topic + "\",\"event\":";
+	event->fragment.append(message, 0, len);
+	event->fragment += '}';
+
+	// Value changes of the same atom can be coalesced; the first
+	// "handle" in the message is always the atom's.
+	if (topic == "tvChanged" or topic == "avChanged")
+	{
+		static const std::string tag = "\"handle\":\"";
+		size_t start = message.find(tag);
+		if (std::string::npos != start)
+		{
+			start += tag.size();
+			size_t end = message.find('"', start);
+			event->key = topic + ":" + message.substr(start, end - start);
+		}
+	}
+	return event;
+}
+
+void EventGateway::dispatch(const gateway_event_ptr& event)
+{
+	std::shared_lock<std::shared_mutex> lock(_sessions_mutex);
+	for (const std::shared_ptr<GatewaySession>& session : _sessions)
+		session->offer(event);
+}
+
+void EventGateway::subscribe()
+{
+	zmq::context_t context(1);
+	zmq::socket_t subscriber(context, ZMQ_SUB);
+	int timeout = 500;
+	subscriber.setsockopt(ZMQ_RCVTIMEO, &timeout, sizeof(timeout));
+	subscriber.setsockopt(ZMQ_SUBSCRIBE, "", 0);
+	subscriber.connect(_config.zmq_endpoint.c_str());
+
+	std::unique_ptr<EventCompressor> decompressor;
+
+	while (_running)
+	{
+		std::vector<std::string> frames;
+		int more = 1;
+		while (more)
+		{
+			zmq::message_t frame;
+			if (not subscriber.recv(&frame))
+				break;
+			frames.emplace_back(static_cast<char*>(frame.data()),
+			                    frame.size());
+			size_t more_size = sizeof(more);
+			subscriber.getsockopt(ZMQ_RCVMORE, &more, &more_size);
+		}
+		if (frames.size() < 2)
+			continue;
+
+		const std::string& topic = frames[0];
+		size_t colon = topic.find(':');
+		if (topic != "dictionary" and std::string::npos == colon)
+		{
+			dispatch(makeEvent(topic, frames[1]));
+			continue;
+		}
+
+		// Compressed publisher output
+		if (frames.size() < 3)
+			continue;
+		Json::Value header;
+		Json::Reader reader;
+		if (not reader.parse(frames[1], header))
+			continue;
+		try
+		{
+			EventCompressor::Codec codec =
+				EventCompressor::parseCodec(header["codec"].asString());
+			if (nullptr == decompressor or decompressor->codec() != codec)
+				decompressor.reset(new EventCompressor(codec));
+
+			if (topic == "dictionary")
+			{
+				decompressor->addDictionary(frames[2]);
+				continue;
+			}
+
+			std::string raw = decompressor->decompress(frames[2],
+				header["size"].asUInt64(), header["dictionary"].asUInt());
+			std::string type = topic.substr(colon + 1);
+			for (const std::string& message :
+			     EventCompressor::splitRecords(raw))
+				dispatch(makeEvent(type, message));
+		}
+		catch (const RuntimeException& e)
+		{
+			logger().warn("[EventGateway] dropping %s batch: %s",
+			              topic.c_str(), e.what());
+		}
+	}
+	subscriber.close();
+}
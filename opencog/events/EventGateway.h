@@ -0,0 +1,178 @@
+/*
+ * opencog/events/EventGateway.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_EVENT_GATEWAY_H
+#define _OPENCOG_EVENT_GATEWAY_H
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <set>
+#include <shared_mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+
+namespace opencog
+{
+
+/**
+ * One published event, prepared once and shared by every client that
+ * receives it.
+ */
+struct gateway_event_t
+{
+	std::string topic;
+
+	// Events with the same non-empty key supersede each other; see
+	// the COALESCE overflow policy.
+	std::string key;
+
+	// {"topic": TOPIC, "event": MESSAGE}, ready to be put in a frame
+	std::string fragment;
+};
+typedef std::shared_ptr<const gateway_event_t> gateway_event_ptr;
+
+struct gateway_config_t
+{
+	// What a client's queue does when it is full
+	enum Policy {
+		DROP_OLDEST,    // discard the oldest queued event
+		DROP_NEWEST,    // discard the incoming event
+		COALESCE        // replace a queued change to the same atom,
+		                // else discard the oldest queued event
+	};
+
+	std::string zmq_endpoint = "tcp://127.0.0.1:5563";
+	std::string address = "0.0.0.0";
+	unsigned short port = 8081;
+	unsigned threads = 0;           // 0: one per core
+	size_t queue_size = 1000;       // per client
+	size_t batch_size = 100;        // events per WebSocket frame
+	Policy policy = DROP_OLDEST;
+
+	static Policy parsePolicy(const std::string& name);
+};
+
+/**
+ * A client's bounded queue of events waiting to be sent, with the
+ * overflow policy applied. It is not thread-safe; the session guards it
+ * with its own lock.
+ */
+class GatewayQueue
+{
+public:
+	GatewayQueue(size_t capacity, gateway_config_t::Policy policy)
+		: _capacity(capacity), _policy(policy), _dropped(0) {}
+
+	void offer(const gateway_event_ptr& event);
+
+	/**
+	 * Moves up to max_events queued events into a WebSocket frame, a
+	 * JSON array, prefixed with a "dropped" entry if events were lost
+	 * since the last frame. Returns false, leaving the frame alone, if
+	 * there is nothing to send.
+	 */
+	bool frame(std::string& out, size_t max_events);
+
+	bool empty() const { return _queue.empty(); }
+	size_t size() const { return _queue.size(); }
+	uint64_t dropped() const { return _dropped; }
+
+private:
+	typedef std::list<gateway_event_ptr> queue_t;
+
+	size_t _capacity;
+	gateway_config_t::Policy _policy;
+	queue_t _queue;
+
+	// Under COALESCE, where the queued event of each key is
+	std::unordered_map<std::string, queue_t::iterator> _pending;
+	uint64_t _dropped;
+
+	void pop_front();
+};
+
+class GatewaySession;
+
+/**
+ * Fans the AtomSpace Publisher event stream out to WebSocket clients.
+ *
+ * A single ZeroMQ subscription feeds every client, so each event is
+ * received and prepared once however many clients there are. Clients
+ * choose the event types they want by sending
+ *
+ *   {"subscribe": ["add", "tvChanged"]}
+ *
+ * (all types, by default). Each client has its own bounded queue, so a
+ * slow browser only loses its own events, according to the configured
+ * overflow policy, and never holds up the others. Events are sent as
+ * JSON arrays of up to batch_size events per WebSocket frame. When
+ * events were dropped for a client, the next frame starts with
+ *
+ *   {"topic": "dropped", "count": N}
+ *
+ * Compressed publisher batches (ZMQ_EVENT_COMPRESSION) are decoded
+ * before being fanned out.
+ */
+class EventGateway
+{
+public:
+	EventGateway(const gateway_config_t& config);
+	~EventGateway();
+
+	/** Serve clients until stop() is called. */
+	void run();
+	void stop();
+
+	const gateway_config_t& config() const { return _config; }
+	size_t clients();
+
+	// Called by sessions
+	void join(const std::shared_ptr<GatewaySession>& session);
+	void leave(GatewaySession* session);
+
+	static gateway_event_ptr makeEvent(const std::string& topic,
+	                                   const std::string& message);
+
+private:
+	gateway_config_t _config;
+	boost::asio::io_context _ioc;
+	boost::asio::ip::tcp::acceptor _acceptor;
+	std::atomic<bool> _running;
+	std::thread _subscriber;
+
+	std::shared_mutex _sessions_mutex;
+	std::set<std::shared_ptr<GatewaySession>> _sessions;
+
+	void accept();
+	void subscribe();
+	void dispatch(const gateway_event_ptr& event);
+};
+
+}
+
+#endif // _OPENCOG_EVENT_GATEWAY_H
@@ -0,0 +1,106 @@
+/*
+ * opencog/events/EventGatewayMain.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <getopt.h>
+
+#include <iostream>
+
+#include <opencog/util/exceptions.h>
+#include <opencog/util/Logger.h>
+
+#include "EventGateway.h"
+
+using namespace opencog;
+
+static void usage(const char* progname)
+{
+	gateway_config_t defaults;
+	std::cerr << "Usage: " << progname << " [options]\n"
+		"Forwards AtomSpace Publisher events to WebSocket clients.\n\n"
+		"  -e, --events ENDPOINT  publisher endpoint ("
+		<< defaults.zmq_endpoint << ")\n"
+		"  -a, --address ADDRESS  WebSocket listen address ("
+		<< defaults.address << ")\n"
+		"  -p, --port PORT        WebSocket port (" << defaults.port << ")\n"
+		"  -t, --threads N        I/O threads (one per core)\n"
+		"  -q, --queue N          events queued per client ("
+		<< defaults.queue_size << ")\n"
+		"  -b, --batch N          events per frame ("
+		<< defaults.batch_size << ")\n"
+		"  -o, --overflow POLICY  drop-oldest, drop-newest or coalesce "
+		"(drop-oldest)\n";
+}
+
+int main(int argc, char* argv[])
+{
+	static const struct option long_options[] = {
+		{"events",   required_argument, 0, 'e'},
+		{"address",  required_argument, 0, 'a'},
+		{"port",     required_argument, 0, 'p'},
+		{"threads",  required_argument, 0, 't'},
+		{"queue",    required_argument, 0, 'q'},
+		{"batch",    required_argument, 0, 'b'},
+		{"overflow", required_argument, 0, 'o'},
+		{"help",     no_argument,       0, 'h'},
+		{0, 0, 0, 0}
+	};
+
+	gateway_config_t config;
+	int c;
+	try
+	{
+		while (-1 != (c = getopt_long(argc, argv, "e:a:p:t:q:b:o:h",
+		                              long_options, nullptr)))
+		{
+			switch (c)
+			{
+				case 'e': config.zmq_endpoint = optarg; break;
+				case 'a': config.address = optarg; break;
+				case 'p': config.port = atoi(optarg); break;
+				case 't': config.threads = atoi(optarg); break;
+				case 'q': config.queue_size = atoi(optarg); break;
+				case 'b': config.batch_size = atoi(optarg); break;
+				case 'o':
+					config.policy = gateway_config_t::parsePolicy(optarg);
+					break;
+				default:
+					usage(argv[0]);
+					return 'h' == c ? 0 : 1;
+			}
+		}
+		if (0 == config.queue_size or 0 == config.batch_size)
+		{
+			usage(argv[0]);
+			return 1;
+		}
+
+		logger().set_print_to_stdout_flag(true);
+		EventGateway gateway(config);
+		gateway.run();
+	}
+	catch (const std::exception& e)
+	{
+		std::cerr << argv[0] << ": " << e.what() << std::endl;
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,330 @@
+/*
+ * opencog/events/EventRing.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <opencog/util/exceptions.h>
+
+#include "EventRing.h"
+
+using namespace opencog;
+
+static const uint64_t RING_MAGIC = 0x474e495256454f43ULL; // "COEVRING"
+static const uint32_t RING_VERSION = 1;
+static const uint32_t PADDING = 0xffffffff;
+static const size_t DATA_OFFSET = 4096;
+static const size_t RECORD_HEADER = 8;
+
+static inline size_t align8(size_t n)
+{
+	return (n + 7) & ~(size_t) 7;
+}
+
+// A record may not be larger than this fraction of the ring, so that
+// a reader can tell whether the writer is about to overwrite it.
+static inline size_t max_record(uint64_t capacity)
+{
+	return capacity / 4;
+}
+
+// How far behind the writer a reader may be and still trust what it
+// reads. A write in progress (a padding marker plus a record) spans
+// less than two records past the head.
+static inline uint64_t safe_distance(uint64_t capacity)
+{
+	return capacity - 2 * max_record(capacity);
+}
+
+static inline uint32_t load32(const char* p)
+{
+	uint32_t v;
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+static inline void store32(char* p, uint32_t v)
+{
+	memcpy(p, &v, sizeof(v));
+}
+
+static long futex(std::atomic<uint32_t>* addr, int op, uint32_t val,
+                  const struct timespec* timeout)
+{
+	// Not FUTEX_PRIVATE_FLAG: the word is shared between processes.
+	return syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), op, val,
+	               timeout, nullptr, 0);
+}
+
+// ---------------------------------------------------------------
+
+EventRing::EventRing(const std::string& name, size_t capacity)
+	: _name(name)
+{
+	uint64_t cap = 4096;
+	while (cap < capacity) cap <<= 1;
+
+	// Start afresh: readers of a previous instance keep their own
+	// mapping of the old, unlinked object.
+	shm_unlink(_name.c_str());
+	int fd = shm_open(_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+	if (fd < 0)
+		throw RuntimeException(TRACE_INFO,
+			"Cannot create event ring %s: %s", _name.c_str(), strerror(errno));
+
+	_mapped = DATA_OFFSET + cap;
+	if (ftruncate(fd, _mapped) < 0)
+	{
+		close(fd);
+		throw RuntimeException(TRACE_INFO,
+			"Cannot size event ring %s: %s", _name.c_str(), strerror(errno));
+	}
+
+	void* base = mmap(nullptr, _mapped, PROT_READ | PROT_WRITE,
+	                  MAP_SHARED, fd, 0);
+	close(fd);
+	if (MAP_FAILED == base)
+		throw RuntimeException(TRACE_INFO,
+			"Cannot map event ring %s: %s", _name.c_str(), strerror(errno));
+
+	_header = new (base) event_ring_header_t();
+	_header->capacity = cap;
+	_header->version = RING_VERSION;
+	_header->head.store(0);
+	_header->futex.store(0);
+	_header->waiters.store(0);
+	_data = static_cast<char*>(base) + DATA_OFFSET;
+
+	// Readers check the magic last.
+	std::atomic_thread_fence(std::memory_order_release);
+	_header->magic = RING_MAGIC;
+}
+
+EventRing::~EventRing()
+{
+	munmap(_header, _mapped);
+	shm_unlink(_name.c_str());
+}
+
+uint64_t EventRing::position() const
+{
+	return _header->head.load(std::memory_order_acquire);
+}
+
+bool EventRing::publish(const std::string& topic, const std::string& payload)
+{
+	const uint64_t cap = _header->capacity;
+	size_t size = align8(RECORD_HEADER + topic.size() + payload.size());
+	if (size > max_record(cap))
+		return false;
+
+	uint64_t pos = _header->head.load(std::memory_order_relaxed);
+	size_t off = pos & (cap - 1);
+	if (off + size > cap)
+	{
+		store32(_data + off, PADDING);
+		pos += cap - off;
+		off = 0;
+	}
+
+	char* rec = _data + off;
+	store32(rec, topic.size() + payload.size());
+	store32(rec + 4, topic.size());
+	memcpy(rec + RECORD_HEADER, topic.data(), topic.size());
+	memcpy(rec + RECORD_HEADER + topic.size(), payload.data(), payload.size());
+
+	// Sequentially consistent, paired with the readers' waiters
+	// increment, so that a reader going to sleep is never missed.
+	_header->head.store(pos + size);
+	if (0 < _header->waiters.load())
+	{
+		_header->futex.fetch_add(1);
+		futex(&_header->futex, FUTEX_WAKE, INT_MAX, nullptr);
+	}
+	return true;
+}
+
+// ---------------------------------------------------------------
+
+EventRingSubscriber::EventRingSubscriber(const std::string& name,
+                                         bool from_start)
+	: _dropped(0)
+{
+	int fd = shm_open(name.c_str(), O_RDWR, 0);
+	if (fd < 0)
+		throw RuntimeException(TRACE_INFO,
+			"Cannot open event ring %s: %s", name.c_str(), strerror(errno));
+
+	struct stat st;
+	if (fstat(fd, &st) < 0 or (size_t) st.st_size < DATA_OFFSET)
+	{
+		close(fd);
+		throw RuntimeException(TRACE_INFO,
+			"Event ring %s is not initialized", name.c_str());
+	}
+	_mapped = st.st_size;
+
+	// Read-write only because the futex and waiter count live in the
+	// header; the data area is never written by readers.
+	void* base = mmap(nullptr, _mapped, PROT_READ | PROT_WRITE,
+	                  MAP_SHARED, fd, 0);
+	close(fd);
+	if (MAP_FAILED == base)
+		throw RuntimeException(TRACE_INFO,
+			"Cannot map event ring %s: %s", name.c_str(), strerror(errno));
+
+	_header = static_cast<event_ring_header_t*>(base);
+	_data = static_cast<const char*>(base) + DATA_OFFSET;
+	if (RING_MAGIC != _header->magic or RING_VERSION != _header->version
+	    or DATA_OFFSET + _header->capacity != _mapped)
+	{
+		munmap(base, _mapped);
+		throw RuntimeException(TRACE_INFO,
+			"%s is not an event ring", name.c_str());
+	}
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	uint64_t head = _header->head.load(std::memory_order_acquire);
+	// Records can only be found by walking from offset zero, so the
+	// backlog is only readable while the writer has not wrapped around.
+	if (from_start and head <= safe_distance(_header->capacity))
+		_tail = 0;
+	else
+		_tail = head;
+}
+
+EventRingSubscriber::~EventRingSubscriber()
+{
+	munmap(_header, _mapped);
+}
+
+bool EventRingSubscriber::try_receive(std::string& topic,
+                                      std::string& payload)
+{
+	const uint64_t cap = _header->capacity;
+	const uint64_t safe = safe_distance(cap);
+
+	while (true)
+	{
+		uint64_t head = _header->head.load(std::memory_order_acquire);
+		if (_tail == head)
+			return false;
+
+		if (head - _tail > safe)
+		{
+			// Overtaken: skip to the current write position.
+			_dropped += head - _tail;
+			_tail = head;
+			return false;
+		}
+
+		size_t off = _tail & (cap - 1);
+		uint32_t len = load32(_data + off);
+		if (PADDING == len)
+		{
+			_tail += cap - off;
+			continue;
+		}
+
+		uint32_t tlen = load32(_data + off + 4);
+		size_t size = align8(RECORD_HEADER + (size_t) len);
+		bool sane = size <= max_record(cap) and tlen <= len
+		            and off + size <= cap;
+		if (sane)
+		{
+			topic.assign(_data + off + RECORD_HEADER, tlen);
+			payload.assign(_data + off + RECORD_HEADER + tlen, len - tlen);
+		}
+
+		// The copy is only valid if the writer did not reach this
+		// record while it was being made.
+		std::atomic_thread_fence(std::memory_order_acquire);
+		head = _header->head.load(std::memory_order_acquire);
+		if (not sane or head - _tail > safe)
+		{
+			_dropped += head - _tail;
+			_tail = head;
+			return false;
+		}
+
+		_tail += size;
+		return true;
+	}
+}
+
+void EventRingSubscriber::wait(int timeout_ms)
+{
+	_header->waiters.fetch_add(1);
+	uint32_t seq = _header->futex.load();
+	if (_header->head.load() == _tail)
+	{
+		struct timespec ts;
+		struct timespec* tsp = nullptr;
+		if (0 <= timeout_ms)
+		{
+			ts.tv_sec = timeout_ms / 1000;
+			ts.tv_nsec = (timeout_ms % 1000) * 1000000L;
+			tsp = &ts;
+		}
+		futex(&_header->futex, FUTEX_WAIT, seq, tsp);
+	}
+	_header->waiters.fetch_sub(1);
+}
+
+bool EventRingSubscriber::receive(std::string& topic, std::string& payload,
+                                  int timeout_ms, unsigned spin)
+{
+	using clock = std::chrono::steady_clock;
+	clock::time_point deadline = clock::now()
+		+ std::chrono::milliseconds(timeout_ms < 0 ? 0 : timeout_ms);
+
+	for (unsigned i = 0; i < spin; i++)
+		if (try_receive(topic, payload))
+			return true;
+
+	while (true)
+	{
+		if (try_receive(topic, payload))
+			return true;
+
+		int remaining = -1;
+		if (0 <= timeout_ms)
+		{
+			remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+				deadline - clock::now()).count();
+			if (remaining <= 0)
+				return try_receive(topic, payload);
+		}
+		wait(remaining);
+	}
+}
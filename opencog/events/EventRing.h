@@ -0,0 +1,133 @@
+/*
+ * opencog/events/EventRing.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_EVENT_RING_H
+#define _OPENCOG_EVENT_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace opencog
+{
+
+/**
+ * Shared-memory transport for AtomSpace events, for subscribers running
+ * on the same host as the CogServer.
+ *
+ * The ring is a POSIX shared memory object (see shm_open(3)) holding a
+ * header followed by a power-of-two sized data area. There is a single
+ * writer, the AtomSpacePublisherModule, and any number of readers. The
+ * writer never waits for readers: a reader that falls more than a ring's
+ * worth behind loses the overwritten events, and is told how many bytes
+ * it skipped. Reading an event that is already in the ring costs no
+ * system call; a reader only enters the kernel (futex wait) when it has
+ * caught up with the writer.
+ *
+ * Each record is a uint32 body length, a uint32 topic length, the topic,
+ * and the payload, padded to 8 bytes. A record never wraps around the end
+ * of the data area; a padding marker is written instead, and the record
+ * starts again at offset zero.
+ */
+struct event_ring_header_t
+{
+	uint64_t magic;
+	uint32_t version;
+	uint32_t reserved;
+	uint64_t capacity;           // size of the data area, in bytes
+
+	// Total number of bytes ever written; the write offset is
+	// head % capacity.
+	alignas(64) std::atomic<uint64_t> head;
+
+	// Bumped by the writer whenever there are sleeping readers.
+	alignas(64) std::atomic<uint32_t> futex;
+	std::atomic<uint32_t> waiters;
+};
+
+/**
+ * The writing end of the ring. Creates (or re-creates) the shared memory
+ * object, and removes it on destruction.
+ */
+class EventRing
+{
+public:
+	EventRing(const std::string& name, size_t capacity);
+	~EventRing();
+
+	/** Append one event; returns false if it is too big for the ring. */
+	bool publish(const std::string& topic, const std::string& payload);
+
+	const std::string& name() const { return _name; }
+	uint64_t position() const;
+
+private:
+	std::string _name;
+	event_ring_header_t* _header;
+	char* _data;
+	size_t _mapped;
+};
+
+/**
+ * The reading end of the ring; the C++ client library for co-located
+ * subscribers. Each subscriber has its own read position, so any number
+ * of them can share one ring. A subscriber is not thread-safe.
+ */
+class EventRingSubscriber
+{
+public:
+	/**
+	 * Attach to an existing ring. By default, only events published
+	 * after this point are received; pass from_start to also receive
+	 * whatever is still in the ring.
+	 */
+	EventRingSubscriber(const std::string& name, bool from_start = false);
+	~EventRingSubscriber();
+
+	/**
+	 * Receive the next event, waiting for at most timeout_ms
+	 * milliseconds (forever, if negative). Returns false on timeout.
+	 * The reader busy-polls spin times before going to sleep.
+	 */
+	bool receive(std::string& topic, std::string& payload,
+	             int timeout_ms = -1, unsigned spin = 1000);
+
+	/** Receive without waiting. */
+	bool try_receive(std::string& topic, std::string& payload);
+
+	/** Bytes of events lost because the writer overtook this reader. */
+	uint64_t dropped() const { return _dropped; }
+
+private:
+	event_ring_header_t* _header;
+	const char* _data;
+	size_t _mapped;
+	uint64_t _tail;
+	uint64_t _dropped;
+
+	void wait(int timeout_ms);
+};
+
+}
+
+#endif // _OPENCOG_EVENT_RING_H
@@ -0,0 +1,107 @@
+/*
+ * opencog/events/SnapshotFormat.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_SNAPSHOT_FORMAT_H
+#define _OPENCOG_SNAPSHOT_FORMAT_H
+
+#include <cstdint>
+
+namespace opencog
+{
+
+/**
+ * Layout of an AtomSpace snapshot file.
+ *
+ * A snapshot is a header, a table of sections, and the sections, each
+ * one starting at an 8-byte aligned offset. Every section but the type
+ * names is one column: one fixed-width value per atom (or per atom plus
+ * one, for offsets). A reader can therefore mmap the file and use the
+ * columns in place, without parsing anything. All integers and floats
+ * are in host byte order (little-endian on all supported platforms).
+ *
+ * Atoms are numbered by row, 0 to atoms - 1. Each link comes after all
+ * of the atoms in its outgoing set, so a mirror can insert the atoms in
+ * one pass, in row order.
+ *
+ * The snapshot is tagged with the publisher's event sequence numbers
+ * (the "sequence" field of every event) taken just before and just after
+ * the atoms were read. Every event numbered up to sequence is reflected
+ * in the snapshot; events numbered up to sequence_end may or may not be.
+ * Remove events are announced before the atom is extracted, so atoms
+ * whose remove was announced are left out of the snapshot, and removes
+ * numbered up to sequence are reflected too. When the publisher only
+ * publishes events for some types, the snapshot only holds atoms of
+ * those types, and the atoms in their outgoing sets.
+ *
+ * A mirror loads the snapshot, then applies every event numbered after
+ * sequence, in sequence order. The events are idempotent (an add of an
+ * existing atom, a remove of a missing one, or a tvChanged carrying the
+ * value already held, changes nothing), so replaying the overlap is
+ * harmless.
+ */
+struct snapshot_header_t
+{
+	uint64_t magic;
+	uint32_t version;
+	uint32_t sections;           // entries in the section table
+	uint64_t atoms;
+	uint64_t sequence;
+	uint64_t sequence_end;
+	uint64_t wall_ns;            // when the snapshot was taken
+	uint64_t reserved[2];
+};
+
+struct snapshot_section_t
+{
+	uint32_t id;                 // a snapshot_column_t
+	uint32_t width;              // bytes per value, 1 for bytes
+	uint64_t offset;             // from the start of the file
+	uint64_t size;               // in bytes, without padding
+};
+
+enum snapshot_column_t
+{
+	// Type names, NUL-terminated, indexed by the values of TYPES and
+	// TV_TYPES. Type numbers depend on how the CogServer was built, so
+	// the names travel with the snapshot.
+	SNAPSHOT_TYPE_NAMES = 1,
+	SNAPSHOT_TYPES,              // uint16
+	SNAPSHOT_HANDLES,            // uint64, the "handle" of the events
+	SNAPSHOT_NAME_OFFSETS,       // uint64, atoms + 1, into NAMES
+	SNAPSHOT_NAMES,              // bytes; links have empty names
+	SNAPSHOT_OUTGOING_OFFSETS,   // uint64, atoms + 1, into OUTGOING
+	SNAPSHOT_OUTGOING,           // uint32 rows
+	SNAPSHOT_TV_TYPES,           // uint16
+	SNAPSHOT_TV_MEAN,            // double
+	SNAPSHOT_TV_CONFIDENCE,      // double
+	SNAPSHOT_TV_COUNT,           // double
+	SNAPSHOT_AV_STI,             // double
+	SNAPSHOT_AV_LTI,             // double
+	SNAPSHOT_AV_VLTI             // uint8
+};
+
+static const uint64_t SNAPSHOT_MAGIC = 0x485350414e534f43ULL; // "COSNAPSH"
+static const uint32_t SNAPSHOT_VERSION = 1;
+
+}
+
+#endif // _OPENCOG_SNAPSHOT_FORMAT_H
@@ -0,0 +1,193 @@
+/*
+ * opencog/events/SnapshotReader.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cerrno>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <opencog/util/exceptions.h>
+
+#include "SnapshotReader.h"
+
+using namespace opencog;
+
+// How many values a column holds, or 0 when any size will do.
+static uint64_t expected_values(uint32_t id, uint64_t atoms)
+{
+	switch (id)
+	{
+		case SNAPSHOT_TYPE_NAMES:
+		case SNAPSHOT_NAMES:
+		case SNAPSHOT_OUTGOING:
+			return 0;
+		case SNAPSHOT_NAME_OFFSETS:
+		case SNAPSHOT_OUTGOING_OFFSETS:
+			return atoms + 1;
+		default:
+			return atoms;
+	}
+}
+
+SnapshotReader::SnapshotReader(const std::string& filename)
+	: _base(nullptr), _mapped(0)
+{
+	int fd = open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw RuntimeException(TRACE_INFO,
+			"Cannot open snapshot %s: %s", filename.c_str(), strerror(errno));
+
+	struct stat st;
+	if (fstat(fd, &st) < 0 or (size_t) st.st_size < sizeof(snapshot_header_t))
+	{
+		close(fd);
+		throw RuntimeException(TRACE_INFO,
+			"Snapshot %s is truncated", filename.c_str());
+	}
+
+	_mapped = st.st_size;
+	_base = mmap(nullptr, _mapped, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (MAP_FAILED == _base)
+		throw RuntimeException(TRACE_INFO,
+			"Cannot map snapshot %s: %s", filename.c_str(), strerror(errno));
+
+	_header = static_cast<const snapshot_header_t*>(_base);
+	_sections = reinterpret_cast<const snapshot_section_t*>(_header + 1);
+
+	// Check the layout up front. The accessors only check the offsets
+	// they use, so that opening a snapshot does not read it all.
+	const char* error = nullptr;
+	if (SNAPSHOT_MAGIC != _header->magic)
+		error = "is not an AtomSpace snapshot";
+	else if (SNAPSHOT_VERSION != _header->version)
+		error = "has an unsupported version";
+	else if (_mapped < sizeof(snapshot_header_t)
+	                   + _header->sections * sizeof(snapshot_section_t))
+		error = "is truncated";
+	for (uint32_t i = 0; nullptr == error and i < _header->sections; i++)
+	{
+		const snapshot_section_t& s = _sections[i];
+		uint64_t values = expected_values(s.id, _header->atoms);
+		if (0 == s.width or 0 != s.offset % 8 or 0 != s.size % s.width)
+			error = "has a malformed section";
+		else if (s.offset > _mapped or s.size > _mapped - s.offset)
+			error = "is truncated";
+		else if (0 != values and s.size / s.width != values)
+			error = "has a column of the wrong length";
+	}
+	if (nullptr != error)
+	{
+		munmap(_base, _mapped);
+		throw RuntimeException(TRACE_INFO,
+			"Snapshot %s %s", filename.c_str(), error);
+	}
+
+	try
+	{
+		_names_size = sectionSize(SNAPSHOT_NAMES, 1);
+		_outgoing_size = sectionSize(SNAPSHOT_OUTGOING, sizeof(uint32_t));
+
+		const char* names = column<char>(SNAPSHOT_TYPE_NAMES);
+		const char* end = names + sectionSize(SNAPSHOT_TYPE_NAMES, 1);
+		while (names < end)
+		{
+			size_t len = strnlen(names, end - names);
+			_type_names.emplace_back(names, len);
+			names += len + 1;
+		}
+	}
+	catch (const RuntimeException&)
+	{
+		munmap(_base, _mapped);
+		throw;
+	}
+}
+
+SnapshotReader::~SnapshotReader()
+{
+	munmap(_base, _mapped);
+}
+
+const snapshot_section_t& SnapshotReader::find(snapshot_column_t id,
+                                                uint32_t width) const
+{
+	for (uint32_t i = 0; i < _header->sections; i++)
+	{
+		const snapshot_section_t& s = _sections[i];
+		if ((uint32_t) id != s.id)
+			continue;
+		if (width != s.width)
+			throw RuntimeException(TRACE_INFO,
+				"Snapshot column %u has %u-byte values, not %u",
+				s.id, s.width, width);
+		return s;
+	}
+	throw RuntimeException(TRACE_INFO,
+		"Snapshot has no column %u", (unsigned) id);
+}
+
+const void* SnapshotReader::section(snapshot_column_t id, uint32_t width) const
+{
+	return static_cast<const char*>(_base) + find(id, width).offset;
+}
+
+uint64_t SnapshotReader::sectionSize(snapshot_column_t id, uint32_t width) const
+{
+	return find(id, width).size / width;
+}
+
+static void check_range(const uint64_t* offsets, size_t row, size_t atoms,
+                        uint64_t limit)
+{
+	if (row >= atoms or offsets[row] > offsets[row + 1]
+	    or offsets[row + 1] > limit)
+		throw RuntimeException(TRACE_INFO,
+			"Snapshot row %zu is out of range or corrupt", row);
+}
+
+std::string SnapshotReader::typeName(uint16_t type) const
+{
+	if (type >= _type_names.size())
+		throw RuntimeException(TRACE_INFO,
+			"Snapshot has no type %u", (unsigned) type);
+	return _type_names[type];
+}
+
+std::string SnapshotReader::name(size_t row) const
+{
+	const uint64_t* offsets = column<uint64_t>(SNAPSHOT_NAME_OFFSETS);
+	check_range(offsets, row, size(), _names_size);
+	const char* names = column<char>(SNAPSHOT_NAMES);
+	return std::string(names + offsets[row], offsets[row + 1] - offsets[row]);
+}
+
+const uint32_t* SnapshotReader::outgoing(size_t row, size_t& arity) const
+{
+	const uint64_t* offsets = column<uint64_t>(SNAPSHOT_OUTGOING_OFFSETS);
+	check_range(offsets, row, size(), _outgoing_size);
+	arity = offsets[row + 1] - offsets[row];
+	return column<uint32_t>(SNAPSHOT_OUTGOING) + offsets[row];
+}
@@ -0,0 +1,90 @@
+/*
+ * opencog/events/SnapshotReader.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_SNAPSHOT_READER_H
+#define _OPENCOG_SNAPSHOT_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "SnapshotFormat.h"
+
+namespace opencog
+{
+
+/**
+ * Read-only view of an AtomSpace snapshot file. The file is mapped, not
+ * read: opening a snapshot costs the same whatever its size, and the
+ * columns are used in place. Does not need an AtomSpace.
+ *
+ *   SnapshotReader snapshot("atomspace.snap");
+ *   const uint16_t* types = snapshot.column<uint16_t>(SNAPSHOT_TYPES);
+ *   for (size_t row = 0; row < snapshot.size(); row++)
+ *       ... snapshot.typeName(types[row]), snapshot.name(row) ...
+ */
+class SnapshotReader
+{
+public:
+	SnapshotReader(const std::string& filename);
+	~SnapshotReader();
+
+	size_t size() const { return _header->atoms; }
+	uint64_t sequence() const { return _header->sequence; }
+	uint64_t sequenceEnd() const { return _header->sequence_end; }
+	uint64_t timestamp() const { return _header->wall_ns; }
+
+	/**
+	 * One value per atom (per atom plus one for the offset columns).
+	 * Throws if the snapshot has no such column, or if T does not have
+	 * the column's width.
+	 */
+	template<typename T>
+	const T* column(snapshot_column_t id) const
+	{
+		return static_cast<const T*>(section(id, sizeof(T)));
+	}
+
+	std::string typeName(uint16_t type) const;
+	std::string name(size_t row) const;
+
+	/** The rows of the outgoing set of a link, and their number. */
+	const uint32_t* outgoing(size_t row, size_t& arity) const;
+
+private:
+	void* _base;
+	size_t _mapped;
+	const snapshot_header_t* _header;
+	const snapshot_section_t* _sections;
+	std::vector<std::string> _type_names;
+	uint64_t _names_size;
+	uint64_t _outgoing_size;
+
+	const snapshot_section_t& find(snapshot_column_t id, uint32_t width) const;
+	const void* section(snapshot_column_t id, uint32_t width) const;
+	uint64_t sectionSize(snapshot_column_t id, uint32_t width) const;
+};
+
+}
+
+#endif // _OPENCOG_SNAPSHOT_READER_H
@@ -0,0 +1,117 @@
+/*
+ * opencog/events/TypeTable.cc
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <atomic>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <sstream>
+
+#include <opencog/util/exceptions.h>
+#include <opencog/atoms/atom_types/NameServer.h>
+
+#include "TypeTable.h"
+
+using namespace opencog;
+
+void TypeSet::insert(Type t)
+{
+	size_t word = t / 64;
+	if (word >= _bits.size())
+		_bits.resize(word + 1, 0);
+	_bits[word] |= (uint64_t) 1 << (t % 64);
+}
+
+void TypeSet::merge(const TypeSet& other)
+{
+	if (other._bits.size() > _bits.size())
+		_bits.resize(other._bits.size(), 0);
+	for (size_t i = 0; i < other._bits.size(); i++)
+		_bits[i] |= other._bits[i];
+}
+
+// ---------------------------------------------------------------
+
+TypeTable::TypeTable()
+{
+	const NameServer& ns = nameserver();
+	Type n = ns.getNumberOfClasses();
+
+	_names.resize(n);
+	_subtypes.resize(n);
+	for (Type t = 0; t < n; t++)
+	{
+		_names[t] = ns.getTypeName(t);
+		for (Type sub = 0; sub < n; sub++)
+			if (ns.isA(sub, t))
+				_subtypes[t].insert(sub);
+	}
+
+	// The parents as declared; the NameServer keeps them apart from the
+	// transitive closure.
+	_parents.resize(n);
+	for (Type t = 0; t < n; t++)
+		ns.getParents(t, std::back_inserter(_parents[t]));
+}
+
+const TypeTable& TypeTable::current()
+{
+	static std::atomic<const TypeTable*> latest(nullptr);
+	static std::mutex mutex;
+	static std::vector<std::unique_ptr<const TypeTable>> tables;
+
+	// Called for every published event; only take the lock when new
+	// types have been added.
+	const TypeTable* table = latest.load(std::memory_order_acquire);
+	if (nullptr != table and table->size() == nameserver().getNumberOfClasses())
+		return *table;
+
+	std::lock_guard<std::mutex> lock(mutex);
+	table = latest.load(std::memory_order_acquire);
+	if (nullptr == table or table->size() != nameserver().getNumberOfClasses())
+	{
+		tables.emplace_back(new TypeTable());
+		table = tables.back().get();
+		latest.store(table, std::memory_order_release);
+	}
+	return *table;
+}
+
+TypeSet TypeTable::subtypes(const std::string& names) const
+{
+	TypeSet set;
+	std::istringstream in(names);
+	std::string name;
+	while (std::getline(in, name, ','))
+	{
+		size_t first = name.find_first_not_of(" \t");
+		if (std::string::npos == first) continue;
+		name = name.substr(first, name.find_last_not_of(" \t") - first + 1);
+
+		Type t = nameserver().getType(name);
+		if (t >= size() or _names[t] != name)
+			throw InvalidParamException(TRACE_INFO,
+				"Unknown atom type %s", name.c_str());
+		set.merge(_subtypes[t]);
+	}
+	return set;
+}
@@ -0,0 +1,102 @@
+/*
+ * opencog/events/TypeTable.h
+ *
+ * Copyright (C) 2026 OpenCog Foundation
+ * All Rights Reserved
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License v3 as
+ * published by the Free Software Foundation and including the exceptions
+ * at http://opencog.org/wiki/Licenses
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program; if not, write to:
+ * Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _OPENCOG_TYPE_TABLE_H
+#define _OPENCOG_TYPE_TABLE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include <opencog/atoms/atom_types/types.h>
+
+namespace opencog
+{
+
+/**
+ * A set of atom types, one bit per type.
+ */
+class TypeSet
+{
+public:
+	bool empty() const { return _bits.empty(); }
+
+	bool contains(Type t) const
+	{
+		size_t word = t / 64;
+		return word < _bits.size() and (_bits[word] >> (t % 64)) & 1;
+	}
+
+	void insert(Type t);
+	void merge(const TypeSet& other);
+
+	const std::vector<uint64_t>& bits() const { return _bits; }
+
+private:
+	std::vector<uint64_t> _bits;
+};
+
+/**
+ * Snapshot of the type hierarchy of the NameServer: the name and the
+ * declared parents of each type, and the set of its subtypes (itself
+ * included). Hierarchy checks are then a bit test, and names an index,
+ * with no lookup in the NameServer.
+ *
+ * Types may be added while the CogServer runs, when modules are
+ * loaded; current() builds a new table whenever that has happened.
+ * Tables are immutable and never freed (there is one per batch of new
+ * types), so references to them stay valid and can be shared between
+ * threads.
+ */
+class TypeTable
+{
+public:
+	static const TypeTable& current();
+
+	size_t size() const { return _names.size(); }
+
+	const std::string& name(Type t) const { return _names.at(t); }
+	const std::vector<Type>& parents(Type t) const { return _parents.at(t); }
+	const TypeSet& subtypes(Type t) const { return _subtypes.at(t); }
+
+	bool isA(Type sub, Type super) const
+	{
+		return super < _subtypes.size() and _subtypes[super].contains(sub);
+	}
+
+	/**
+	 * All the subtypes of the named types, e.g. "Node, EvaluationLink".
+	 * Throws InvalidParamException for an unknown type name.
+	 */
+	TypeSet subtypes(const std::string& names) const;
+
+private:
+	TypeTable();
+
+	std::vector<std::string> _names;
+	std::vector<std::vector<Type>> _parents;
+	std::vector<TypeSet> _subtypes;
+};
+
+}
+
+#endif // _OPENCOG_TYPE_TABLE_H
@@ -6,6 +6,7 @@ import opencog.cogserver
 from opencog.atomspace import Atom
 from opencog.web.api.mappers import *
 from flask_restful.utils import cors
+from werkzeug.exceptions import HTTPException
 
 # I can't find swagger on ubuntu .. wtf!? FIXME
 from flask_restful_swagger import swagger
@@ -13,6 +14,7 @@ from opencog.bank import AttentionBank
 
 # Temporary hack
 from opencog.web.api.utilities import get_atoms_by_name
+from opencog.web.api import typetable
 
 # If the system doesn't have these dependencies installed, display a warning
 # but allow the API to load
@@ -274,6 +276,9 @@ class AtomCollectionAPI(Resource):
         retval = jsonify({'error':'Internal error'})
         try:
            retval = self._get(id=id)
+        except HTTPException:
+           # Rejected requests keep their status code
+           raise
         except Exception as e:
            retval = jsonify({'error':str(e)})
         return retval
@@ -332,10 +337,17 @@ class AtomCollectionAPI(Resource):
                 if type is None and name is None:
                     atoms = self.atomspace.get_atoms_by_type(types.Atom)
                 elif name is None:
+                    table = typetable.current()
+                    unknown = [t for t in type if t not in table.ids]
+                    if unknown:
+                        abort(400, 'Invalid request: unknown atom type ' +
+                                   ', '.join(unknown))
+
+                    # Subtypes are included, so skip the types already
+                    # covered by another one
                     atoms = []
-                    for t in type:
-                         atoms = atoms + self.atomspace.get_atoms_by_type(
-                                           types.__dict__.get(t))
+                    for t in table.covering(type):
+                         atoms = atoms + self.atomspace.get_atoms_by_type(t)
                 else:
                     if type is None:
                         type = ['Node']
@@ -547,7 +559,7 @@ the atom. Example:
         name = data['name'] if 'name' in data else None
 
         # Nodes must have names
-        if is_a(type, types.Node):
+        if typetable.current().is_a(type, types.Node):
             if name is None:
                 abort(400, 'Invalid request: node type specified and required '
                            'parameter name is missing')
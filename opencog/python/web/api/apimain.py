@@ -8,6 +8,7 @@ from opencog.web.api.apitypes import *
 from opencog.web.api.apishell import *
 from opencog.web.api.apischeme import *
 from opencog.web.api.apighost import *
+from opencog.web.api.apisnapshot import *
 from flask_restful_swagger import swagger
 
 
@@ -50,6 +51,7 @@ class RESTAPI(object):
         shell_api = ShellAPI
         scheme_api = SchemeAPI.new(self.atomspace)
         ghost_api = GhostApi.new(self.atomspace)
+        snapshot_api = SnapshotAPI
 
         self.api.decorators=[cors.crossdomain(origin='*', automatic_options=False)]
 
@@ -68,6 +70,9 @@ class RESTAPI(object):
         self.api.add_resource(ghost_api, 
                               '/api/v1.1/ghost', 
                               endpoint='ghost')
+        self.api.add_resource(snapshot_api,
+                              '/api/v1.1/snapshot',
+                              endpoint='snapshot')
 
 
     def run(self, host='127.0.0.1', port=5000):
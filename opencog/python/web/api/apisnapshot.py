@@ -0,0 +1,115 @@
+import os
+import re
+import socket
+import tempfile
+
+from flask import abort, current_app
+from flask_restful import Resource
+from flask_restful_swagger import swagger
+
+COGSERVER_PORT = 17001
+
+# A snapshot of millions of atoms takes a while to capture
+SNAPSHOT_TIMEOUT = 600
+
+CHUNK_SIZE = 1 << 20
+
+SNAPSHOT_REPLY = re.compile(
+    r'Snapshot of (?P<atoms>\d+) atoms at sequence (?P<sequence>\d+) '
+    r'\(up to (?P<sequence_end>\d+)\)')
+PROMPT = re.compile(r'\x1b\[[0-9;]*m|opencog> ')
+
+
+def shell_command(command, timeout=SNAPSHOT_TIMEOUT):
+    """
+    Runs one command in the CogServer shell and returns its reply, without
+    the prompts
+    """
+    connection = socket.create_connection(('localhost', COGSERVER_PORT),
+                                          timeout)
+    try:
+        connection.sendall((command + '\n').encode('utf-8'))
+        reply = ''
+        while '\n' not in reply:
+            data = connection.recv(4096)
+            if not data:
+                break
+            reply += PROMPT.sub('', data.decode('utf-8', 'replace'))
+            reply = reply.lstrip()
+        return reply
+    finally:
+        connection.close()
+
+
+class SnapshotAPI(Resource):
+    """
+    Streams a snapshot of the whole AtomSpace, in the columnar binary
+    format of the AtomSpace Publisher (opencog/events/SnapshotFormat.h)
+    """
+
+    @swagger.operation(
+	notes='''
+Returns a snapshot of the AtomSpace, for bootstrapping a client that then
+follows the AtomSpace Publisher event stream.
+
+<p>The body is a binary file, laid out as described in
+opencog/events/SnapshotFormat.h. It can be saved and memory-mapped, for
+example with opencog/python/web/api/snapshot.py.
+
+<p>The X-OpenCog-Sequence header gives the sequence number of the last
+event reflected in the snapshot: apply every event with a greater
+"sequence", in sequence order, to bring the snapshot up to date. Events up to
+X-OpenCog-Sequence-End may already be reflected; applying them again is
+harmless.
+
+<p>Requires the AtomSpace Publisher module to be loaded in the CogServer.''',
+	responseClass='response',
+	nickname='get',
+	parameters=[
+	],
+	responseMessages=[
+	    {'code': 200, 'message': 'Returned the snapshot'},
+	    {'code': 503, 'message': 'The CogServer or the AtomSpace Publisher '
+	                             'module is not available'}
+	]
+    )
+    def get(self):
+        """
+        Returns a snapshot of the AtomSpace
+        """
+
+        # The CogServer writes the snapshot; it runs on this host.
+        fd, path = tempfile.mkstemp(prefix='atomspace-', suffix='.snap')
+        os.close(fd)
+        try:
+            reply = shell_command('publisher-snapshot ' + path)
+            match = SNAPSHOT_REPLY.search(reply)
+            snapshot = open(path, 'rb') if match else None
+        except (socket.error, IOError) as e:
+            match, reply = None, str(e)
+        finally:
+            # An open file stays readable once unlinked
+            os.remove(path)
+
+        if match is None:
+            abort(503, 'Cannot take a snapshot: ' + reply.strip())
+
+        def stream():
+            with snapshot:
+                while True:
+                    chunk = snapshot.read(CHUNK_SIZE)
+                    if not chunk:
+                        break
+                    yield chunk
+
+        response = current_app.response_class(
+            stream(), mimetype='application/octet-stream')
+        response.headers['Content-Length'] = \
+            str(os.fstat(snapshot.fileno()).st_size)
+        response.headers['Content-Disposition'] = \
+            'attachment; filename=atomspace.snap'
+        response.headers['X-OpenCog-Atoms'] = match.group('atoms')
+        response.headers['X-OpenCog-Sequence'] = match.group('sequence')
+        response.headers['X-OpenCog-Sequence-End'] = \
+            match.group('sequence_end')
+        return response
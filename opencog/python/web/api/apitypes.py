@@ -1,8 +1,11 @@
 __author__ = 'Cosmo Harrigan'
 
-from flask import json, current_app
+import hashlib
+
+from flask import json, current_app, request
 from flask_restful import Resource, reqparse
 from opencog.web.api.mappers import *
+from opencog.web.api import typetable
 from flask_restful.utils import cors
 from flask_restful_swagger import swagger
 
@@ -17,14 +20,25 @@ class TypesAPI(Resource):
     @cors.crossdomain(origin='*')
     @swagger.operation(
 	notes='''
-Returns a JSON representation of a list of valid atom types
+Returns a JSON representation of a list of valid atom types, and of the
+type hierarchy
 
 <p>Example:
 
 <pre>
-{"types": ["TrueLink", "NumberNode", "OrLink",
-  "PrepositionalRelationshipNode"]}
+{"version": "5d41402abc4b2a76",
+ "types": ["Atom", "Node", "Link", "ConceptNode", ...],
+ "hierarchy": [
+   {"id": 2, "name": "Node", "parents": [1], "subtypes": "3fff...4"},
+   {"id": 4, "name": "ConceptNode", "parents": [2], "subtypes": "10"},
+   ...]}
 </pre>
+
+<p>"subtypes" is a bitset in hexadecimal: bit n is set when type n is
+a subtype of the type (or the type itself). The table only changes when
+types are registered; "version" is also sent as the ETag, so clients can
+send If-None-Match and get 304 Not Modified. JSONP responses have an ETag
+of their own, made of the version and the callback.
 ''',
 	responseClass='response',
 	nickname='get',
@@ -32,6 +46,7 @@ Returns a JSON representation of a list of valid atom types
 	],
 	responseMessages=[
 	    {'code': 200, 'message': 'Returned list of valid atom types'},
+	    {'code': 304, 'message': 'The type table has not changed'},
 	]
     )
     def get(self):
@@ -39,18 +54,28 @@ Returns a JSON representation of a list of valid atom types
         Returns a list of valid atom types
         """
 
-        json_data = \
-            {'types': filter(lambda x:
-                             not x.startswith('__') and not x.endswith('__')
-                             and not x == 'NO_TYPE', types.__dict__.keys())}
+        table = typetable.current()
 
         # if callback function supplied, pad the JSON data (i.e. JSONP):
         args = self.reqparse.parse_args()
         callback = args.get('callback')
+
+        # The padded body is not the plain one, so it needs another ETag
+        etag = table.version
         if callback is not None:
-            response = str(callback) + '(' + json.dumps(json_data) + ');'
-            return current_app.response_class(
-                response, mimetype='application/javascript')
+            etag += '-' + hashlib.sha1(
+                str(callback).encode('utf-8')).hexdigest()[:8]
+
+        if etag in request.if_none_match:
+            response = current_app.response_class(status=304)
+        elif callback is not None:
+            response = current_app.response_class(
+                str(callback) + '(' + table.json + ');',
+                mimetype='application/javascript')
         else:
-            return current_app.response_class(
-                json.dumps(json_data), mimetype='application/json')
+            response = current_app.response_class(
+                table.json, mimetype='application/json')
+
+        response.set_etag(etag)
+        response.headers['Cache-Control'] = 'no-cache'
+        return response
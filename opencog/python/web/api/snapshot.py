@@ -0,0 +1,102 @@
+"""
+Reader for AtomSpace snapshots, as written by the publisher-snapshot
+CogServer command and served by the /api/v1.1/snapshot resource.
+
+The layout is described in opencog/events/SnapshotFormat.h. The file is
+memory-mapped and each column is returned as a memoryview over the
+mapping, so opening even a very large snapshot is immediate, and the
+columns can be handed to numpy without a copy:
+
+    snapshot = Snapshot('atomspace.snap')
+    types = snapshot.column(Snapshot.TYPES)
+    for row in range(len(snapshot)):
+        print(snapshot.type_name(types[row]), snapshot.name(row))
+
+    sti = numpy.frombuffer(snapshot.column(Snapshot.AV_STI), numpy.float64)
+
+Requires Python 3.3 or later, for memoryview.cast.
+"""
+
+import mmap
+import struct
+
+MAGIC = b'COSNAPSH'
+VERSION = 1
+
+_HEADER = struct.Struct('<8sIIQQQQ16x')
+_SECTION = struct.Struct('<IIQQ')
+
+
+class Snapshot(object):
+    TYPE_NAMES = 1
+    TYPES = 2
+    HANDLES = 3
+    NAME_OFFSETS = 4
+    NAMES = 5
+    OUTGOING_OFFSETS = 6
+    OUTGOING = 7
+    TV_TYPES = 8
+    TV_MEAN = 9
+    TV_CONFIDENCE = 10
+    TV_COUNT = 11
+    AV_STI = 12
+    AV_LTI = 13
+    AV_VLTI = 14
+
+    # memoryview formats of the columns
+    _FORMATS = {
+        TYPE_NAMES: 'B', TYPES: 'H', HANDLES: 'Q', NAME_OFFSETS: 'Q',
+        NAMES: 'B', OUTGOING_OFFSETS: 'Q', OUTGOING: 'I', TV_TYPES: 'H',
+        TV_MEAN: 'd', TV_CONFIDENCE: 'd', TV_COUNT: 'd', AV_STI: 'd',
+        AV_LTI: 'd', AV_VLTI: 'B'
+    }
+
+    def __init__(self, filename):
+        with open(filename, 'rb') as f:
+            self._map = mmap.mmap(f.fileno(), 0, access=mmap.ACCESS_READ)
+
+        if len(self._map) < _HEADER.size:
+            raise ValueError(filename + ' is truncated')
+        (magic, version, sections, self.atoms, self.sequence,
+         self.sequence_end, self.timestamp_ns) = \
+            _HEADER.unpack_from(self._map, 0)
+        if magic != MAGIC:
+            raise ValueError(filename + ' is not an AtomSpace snapshot')
+        if version != VERSION:
+            raise ValueError(filename + ' has an unsupported version')
+
+        self._sections = {}
+        for i in range(sections):
+            column, width, offset, size = _SECTION.unpack_from(
+                self._map, _HEADER.size + i * _SECTION.size)
+            if offset + size > len(self._map):
+                raise ValueError(filename + ' is truncated')
+            self._sections[column] = (offset, size)
+
+        names = bytes(self.column(Snapshot.TYPE_NAMES))
+        self._type_names = [n.decode('utf-8') for n in names.split(b'\0')[:-1]]
+
+    def __len__(self):
+        return self.atoms
+
+    def column(self, column):
+        """
+        The values of one column, one per atom (per atom plus one for the
+        offset columns), without copying them out of the file.
+        """
+        offset, size = self._sections[column]
+        view = memoryview(self._map)[offset:offset + size]
+        return view.cast(Snapshot._FORMATS[column])
+
+    def type_name(self, type):
+        return self._type_names[type]
+
+    def name(self, row):
+        offsets = self.column(Snapshot.NAME_OFFSETS)
+        names = self.column(Snapshot.NAMES)
+        return bytes(names[offsets[row]:offsets[row + 1]]).decode('utf-8')
+
+    def outgoing(self, row):
+        """The rows of the outgoing set of a link; rows come before links."""
+        offsets = self.column(Snapshot.OUTGOING_OFFSETS)
+        return self.column(Snapshot.OUTGOING)[offsets[row]:offsets[row + 1]]
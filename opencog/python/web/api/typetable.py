@@ -0,0 +1,105 @@
+"""
+Precomputed table of the atom types: their names, ids, direct parents,
+and a subtype bitset for each type (bit n standing for type n), as
+served by the /api/v1.1/types resource.
+
+The table is built once, and again only when new types have been
+registered. Its version is a hash of its contents, so clients can cache
+it and revalidate with ETags. Hierarchy checks against the table are a
+bit test:
+
+    table = typetable.current()
+    if table.is_a(atom_type, types.Node):
+        ...
+"""
+
+import hashlib
+import json
+
+from opencog.atomspace import types, is_a
+
+
+def type_ids():
+    """Type name to type id, for all the registered types."""
+    return dict((name, id) for name, id in types.__dict__.items()
+                if not name.startswith('__') and not name.endswith('__')
+                and not name == 'NO_TYPE' and isinstance(id, int))
+
+
+class TypeTable(object):
+    def __init__(self, ids=None):
+        ids = type_ids() if ids is None else ids
+        self.ids = ids
+        self.names = dict((id, name) for name, id in ids.items())
+        order = sorted(self.names)
+
+        # subtypes[t] has bit s set when s is a t
+        self.subtypes = dict((t, 0) for t in order)
+        supertypes = dict((t, set()) for t in order)
+        for t in order:
+            for s in order:
+                if is_a(s, t):
+                    self.subtypes[t] |= 1 << s
+                    supertypes[s].add(t)
+
+        # The direct parents are the supertypes that are not supertypes of
+        # another supertype.
+        self.parents = {}
+        for t in order:
+            strict = supertypes[t] - set([t])
+            self.parents[t] = sorted(
+                p for p in strict
+                if not any(p != m and p in supertypes[m] for m in strict))
+
+        hierarchy = [{'id': t,
+                      'name': self.names[t],
+                      'parents': self.parents[t],
+                      'subtypes': '%x' % self.subtypes[t]} for t in order]
+        contents = json.dumps(hierarchy, sort_keys=True, separators=(',', ':'))
+        self.version = hashlib.sha1(contents.encode('utf-8')).hexdigest()[:16]
+
+        # Served as is
+        self.json = json.dumps({'version': self.version,
+                                'types': [self.names[t] for t in order],
+                                'hierarchy': hierarchy},
+                               separators=(',', ':'))
+
+    def __len__(self):
+        return len(self.names)
+
+    def is_a(self, sub, super):
+        return (self.subtypes.get(super, 0) >> sub) & 1 == 1
+
+    def mask(self, names):
+        """Bitset of all the subtypes of the named types."""
+        mask = 0
+        for name in names:
+            mask |= self.subtypes[self.ids[name]]
+        return mask
+
+    def covering(self, names):
+        """
+        The named types, less those that are subtypes of another one:
+        fetching atoms by each of them, subtypes included, gets every atom
+        exactly once.
+        """
+        wanted = set(self.ids[name] for name in names if name in self.ids)
+        return sorted(t for t in wanted
+                      if not any(t != u and self.is_a(t, u) for u in wanted))
+
+
+_current = None
+_registered = 0
+
+
+def current():
+    """The type table, rebuilt if types have been added since."""
+    global _current, _registered
+    # Registering a type adds it to the types module, so the size of the
+    # module is enough to tell; listing the types on every call is not
+    # needed.
+    registered = len(types.__dict__)
+    if _current is None or registered != _registered:
+        _current = TypeTable()
+        _registered = registered
+    return _current
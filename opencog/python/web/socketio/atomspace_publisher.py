@@ -31,6 +31,10 @@ path is: opencog/persist/zmq/events/libatomspacepublishermodule.so
 
 For more details on how to work with socket.io, visit:
 http://socket.io/
+
+Deprecated: use atomspace-event-gateway (opencog/events) instead. All
+connections here read from one shared ZeroMQ socket, so each event
+reaches only one client, and a slow client stalls the others.
 """
 
 __author__ = 'Cosmo Harrigan'
@@ -405,6 +405,55 @@ class TestRESTApi():
         assert len(get_result) > 0
         assert get_result.__contains__('ConceptNode')
 
+    def test_j_get_type_hierarchy(self):
+        get_response = self.client.get(self.uri + 'types')
+        result = json.loads(get_response.data)
+        hierarchy = dict((t['name'], t) for t in result['hierarchy'])
+        concept = hierarchy['ConceptNode']
+        node = hierarchy['Node']
+        assert node['id'] in concept['parents']
+        assert (int(node['subtypes'], 16) >> concept['id']) & 1
+        assert not (int(concept['subtypes'], 16) >> node['id']) & 1
+
+        # The table is versioned; an unchanged table is not sent again
+        etag = get_response.headers['ETag']
+        assert result['version'] in etag
+        get_response = self.client.get(self.uri + 'types',
+                                       headers={'If-None-Match': etag})
+        assert get_response.status_code == 304
+
+        # The JSONP body is padded, so its ETag is not the same
+        get_response = self.client.get(self.uri + 'types?callback=f',
+                                       headers={'If-None-Match': etag})
+        assert get_response.status_code == 200
+        jsonp_etag = get_response.headers['ETag']
+        assert jsonp_etag != etag
+        assert get_response.data.decode('utf-8').startswith('f(')
+        get_response = self.client.get(self.uri + 'types?callback=f',
+                                       headers={'If-None-Match': jsonp_etag})
+        assert get_response.status_code == 304
+        get_response = self.client.get(self.uri + 'types?callback=g',
+                                       headers={'If-None-Match': jsonp_etag})
+        assert get_response.status_code == 200
+
+    def test_k_type_filter(self):
+        # Should return animal, bird, swan and frog (4 atoms), once each,
+        # although ConceptNode is also a Node
+        get_response = self.client.get(self.uri + 'atoms?type=ConceptNode')
+        get_result = json.loads(get_response.data)['result']['atoms']
+        assert len(get_result) == 4
+        get_response = self.client.get(
+            self.uri + 'atoms?type=ConceptNode&type=Node')
+        get_result = json.loads(get_response.data)['result']['atoms']
+        assert len(get_result) == 4
+
+        # Unknown types are rejected, not ignored
+        get_response = self.client.get(self.uri + 'atoms?type=ConceptNod')
+        assert get_response.status_code == 400
+        get_response = self.client.get(
+            self.uri + 'atoms?type=ConceptNode&type=__name__')
+        assert get_response.status_code == 400
+
     def test_k_tv_filter(self):
         # Should return animal, swan_bird, bird_animal (3 atoms)
         get_response = self.client.get(self.uri + 'atoms?tvStrengthMin=0.1')
@@ -470,3 +519,9 @@ class TestRESTApi():
             assert get_result.count("label") == 2
         except ImportError:
             pass
+
+    def test_o_snapshot_needs_cogserver(self):
+        # Snapshots are taken by the AtomSpace Publisher module in the
+        # CogServer, which is not running here
+        get_response = self.client.get(self.uri + 'snapshot')
+        assert get_response.status_code == 503
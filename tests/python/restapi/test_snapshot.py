@@ -0,0 +1,147 @@
+from nose.tools import *
+import os
+import struct
+import tempfile
+
+from web.api.snapshot import Snapshot
+
+
+def align(n):
+    return (n + 7) & ~7
+
+
+def write_snapshot(columns, atoms, sequence=0, sequence_end=0,
+                   magic=b'COSNAPSH', version=1):
+    """
+    Lays out a snapshot as described in opencog/events/SnapshotFormat.h:
+    the header, the section table, then each column at an 8-byte aligned
+    offset. columns is a list of (id, width, bytes). Returns the file
+    name and the offset of each column.
+    """
+    header = struct.pack('<8sIIQQQQ16x', magic, version, len(columns),
+                         atoms, sequence, sequence_end, 1234567890)
+    offset = align(len(header) + 24 * len(columns))
+    table = b''
+    offsets = {}
+    for column, width, data in columns:
+        table += struct.pack('<IIQQ', column, width, offset, len(data))
+        offsets[column] = offset
+        offset = align(offset + len(data))
+
+    body = header + table
+    for column, width, data in columns:
+        body += b'\0' * (offsets[column] - len(body)) + data
+
+    fd, filename = tempfile.mkstemp(suffix='.snap')
+    with os.fdopen(fd, 'wb') as f:
+        f.write(body)
+    return filename, offsets
+
+
+class TestSnapshot():
+    """
+    Unit tests for the snapshot reader, against files built by hand.
+
+    See: opencog/python/web/api/snapshot.py
+    """
+
+    # ConceptNode "cat", ConceptNode "animal", and an InheritanceLink
+    # between them
+    TYPE_NAMES = b'Node\0ConceptNode\0InheritanceLink\0SimpleTruthValue\0'
+    COLUMNS = [
+        (Snapshot.TYPE_NAMES, 1, TYPE_NAMES),
+        (Snapshot.TYPES, 2, struct.pack('<3H', 1, 1, 2)),
+        (Snapshot.HANDLES, 8, struct.pack('<3Q', 11, 22, 33)),
+        (Snapshot.NAME_OFFSETS, 8, struct.pack('<4Q', 0, 3, 9, 9)),
+        (Snapshot.NAMES, 1, b'catanimal'),
+        (Snapshot.OUTGOING_OFFSETS, 8, struct.pack('<4Q', 0, 0, 0, 2)),
+        (Snapshot.OUTGOING, 4, struct.pack('<2I', 0, 1)),
+        (Snapshot.TV_TYPES, 2, struct.pack('<3H', 3, 3, 3)),
+        (Snapshot.TV_MEAN, 8, struct.pack('<3d', 0.5, 0.25, 1.0)),
+        (Snapshot.TV_CONFIDENCE, 8, struct.pack('<3d', 0.1, 0.2, 0.9)),
+        (Snapshot.TV_COUNT, 8, struct.pack('<3d', 1.0, 2.0, 9.0)),
+        (Snapshot.AV_STI, 8, struct.pack('<3d', 9.0, 0.0, -1.0)),
+        (Snapshot.AV_LTI, 8, struct.pack('<3d', 0.0, 0.0, 0.0)),
+        (Snapshot.AV_VLTI, 1, struct.pack('<3B', 0, 1, 0)),
+    ]
+
+    def setUp(self):
+        self.filename, self.offsets = write_snapshot(
+            TestSnapshot.COLUMNS, 3, sequence=41, sequence_end=44)
+        self.snapshot = Snapshot(self.filename)
+
+    def tearDown(self):
+        del self.snapshot
+        os.remove(self.filename)
+
+    def test_header(self):
+        assert_equal(len(self.snapshot), 3)
+        assert_equal(self.snapshot.sequence, 41)
+        assert_equal(self.snapshot.sequence_end, 44)
+        assert_equal(self.snapshot.timestamp_ns, 1234567890)
+
+    def test_section_offsets(self):
+        # 64 byte header, 14 sections of 24 bytes; the type names are
+        # 50 bytes long, so the types start after 6 bytes of padding.
+        assert_equal(self.offsets[Snapshot.TYPE_NAMES], 400)
+        assert_equal(self.offsets[Snapshot.TYPES], 456)
+        for column, width, data in TestSnapshot.COLUMNS:
+            offset, size = self.snapshot._sections[column]
+            assert_equal(offset, self.offsets[column])
+            assert_equal(offset % 8, 0)
+            assert_equal(size, len(data))
+
+    def test_columns(self):
+        s = self.snapshot
+        assert_equal(list(s.column(Snapshot.TYPES)), [1, 1, 2])
+        assert_equal(list(s.column(Snapshot.HANDLES)), [11, 22, 33])
+        assert_equal(list(s.column(Snapshot.TV_MEAN)), [0.5, 0.25, 1.0])
+        assert_equal(list(s.column(Snapshot.TV_CONFIDENCE)), [0.1, 0.2, 0.9])
+        assert_equal(list(s.column(Snapshot.TV_COUNT)), [1.0, 2.0, 9.0])
+        assert_equal(list(s.column(Snapshot.AV_STI)), [9.0, 0.0, -1.0])
+        assert_equal(list(s.column(Snapshot.AV_VLTI)), [0, 1, 0])
+
+    def test_type_names(self):
+        s = self.snapshot
+        types = s.column(Snapshot.TYPES)
+        assert_equal([s.type_name(t) for t in types],
+                     ['ConceptNode', 'ConceptNode', 'InheritanceLink'])
+        assert_equal(s.type_name(s.column(Snapshot.TV_TYPES)[0]),
+                     'SimpleTruthValue')
+
+    def test_name(self):
+        assert_equal(self.snapshot.name(0), 'cat')
+        assert_equal(self.snapshot.name(1), 'animal')
+        assert_equal(self.snapshot.name(2), '')
+
+    def test_outgoing(self):
+        assert_equal(list(self.snapshot.outgoing(0)), [])
+        assert_equal(list(self.snapshot.outgoing(1)), [])
+        assert_equal(list(self.snapshot.outgoing(2)), [0, 1])
+
+
+def test_bad_magic():
+    filename, offsets = write_snapshot(TestSnapshot.COLUMNS, 3,
+                                       magic=b'NOTASNAP')
+    try:
+        assert_raises(ValueError, Snapshot, filename)
+    finally:
+        os.remove(filename)
+
+
+def test_bad_version():
+    filename, offsets = write_snapshot(TestSnapshot.COLUMNS, 3, version=2)
+    try:
+        assert_raises(ValueError, Snapshot, filename)
+    finally:
+        os.remove(filename)
+
+
+def test_truncated():
+    filename, offsets = write_snapshot(TestSnapshot.COLUMNS, 3)
+    with open(filename, 'r+b') as f:
+        f.truncate(offsets[Snapshot.AV_VLTI] + 1)
+    try:
+        assert_raises(ValueError, Snapshot, filename)
+    finally:
+        os.remove(filename)